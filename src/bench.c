@@ -0,0 +1,331 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "s21_matrix.h"
+
+#define WARMUP_SECONDS 0.05
+#define CASE_SECONDS 0.25
+#define SAMPLE_SECONDS 1e-4
+#define MIN_SAMPLES 11
+#define MAX_SAMPLES 1000
+#define MAX_BASELINE 128
+
+typedef struct {
+  matrix_t a, b, result;
+  double det;
+} bench_args_t;
+
+/* one call of the measured function; results are removed in the same call */
+typedef void (*bench_fn)(bench_args_t *);
+
+typedef struct {
+  const char *name;
+  bench_fn run;
+  /* operands are m x k and k x n; k is 0 for single-operand functions */
+  int shapes[8][3];
+  double (*flops)(double m, double n, double k);
+  double (*bytes)(double m, double n, double k);
+} bench_case_t;
+
+typedef struct {
+  int ops;
+  int samples;
+  double median_ns, p99_ns;
+} bench_result_t;
+
+typedef struct {
+  char function[64];
+  int rows, columns, inner;
+  double median_ns;
+} bench_baseline_t;
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* reseeded per operand, so same-shaped operands are equal and
+ * s21_eq_matrix has to compare every element */
+static void fill_random(matrix_t *a) {
+  for (int i = 0; i < a->rows; i++)
+    for (int j = 0; j < a->columns; j++)
+      a->matrix[i][j] = rand() / (double)RAND_MAX - 0.5 + (i == j) * 2.0;
+}
+
+static void run_create(bench_args_t *x) {
+  s21_create_matrix(x->a.rows, x->a.columns, &x->result);
+  s21_remove_matrix(&x->result);
+}
+
+static void run_eq(bench_args_t *x) { x->det += s21_eq_matrix(&x->a, &x->b); }
+
+static void run_sum(bench_args_t *x) {
+  s21_sum_matrix(&x->a, &x->b, &x->result);
+  s21_remove_matrix(&x->result);
+}
+
+static void run_sub(bench_args_t *x) {
+  s21_sub_matrix(&x->a, &x->b, &x->result);
+  s21_remove_matrix(&x->result);
+}
+
+static void run_mult_number(bench_args_t *x) {
+  s21_mult_number(&x->a, 1.5, &x->result);
+  s21_remove_matrix(&x->result);
+}
+
+static void run_mult_matrix(bench_args_t *x) {
+  s21_mult_matrix(&x->a, &x->b, &x->result);
+  s21_remove_matrix(&x->result);
+}
+
+static void run_transpose(bench_args_t *x) {
+  s21_transpose(&x->a, &x->result);
+  s21_remove_matrix(&x->result);
+}
+
+static void run_complements(bench_args_t *x) {
+  s21_calc_complements(&x->a, &x->result);
+  s21_remove_matrix(&x->result);
+}
+
+static void run_determinant(bench_args_t *x) {
+  s21_determinant(&x->a, &x->det);
+}
+
+static void run_inverse(bench_args_t *x) {
+  s21_inverse_matrix(&x->a, &x->result);
+  s21_remove_matrix(&x->result);
+}
+
+static double no_flops(double m, double n, double k) {
+  (void)m, (void)n, (void)k;
+  return 0.0;
+}
+
+static double elementwise_flops(double m, double n, double k) {
+  (void)k;
+  return m * n;
+}
+
+static double product_flops(double m, double n, double k) {
+  return 2.0 * m * n * k;
+}
+
+/* LU is 2n^3/3; inverse and complements add the n^3 + n^3/3 solves */
+static double lu_flops(double m, double n, double k) {
+  (void)n, (void)k;
+  return 2.0 * m * m * m / 3.0;
+}
+
+static double inverse_flops(double m, double n, double k) {
+  (void)n, (void)k;
+  return 2.0 * m * m * m;
+}
+
+/* bytes models count each operand read and each result written once */
+static double one_matrix(double m, double n, double k) {
+  (void)k;
+  return 8.0 * m * n;
+}
+
+static double two_matrices(double m, double n, double k) {
+  (void)k;
+  return 16.0 * m * n;
+}
+
+static double three_matrices(double m, double n, double k) {
+  (void)k;
+  return 24.0 * m * n;
+}
+
+static double product_bytes(double m, double n, double k) {
+  return 8.0 * (m * k + k * n + m * n);
+}
+
+#define SQUARE(n) {n, n, 0}
+#define ELEMENTWISE_SHAPES                                                \
+  {SQUARE(4), SQUARE(16), SQUARE(64), SQUARE(256), SQUARE(1024),          \
+   SQUARE(2048), {4096, 16, 0}, {16, 4096, 0}}
+#define CUBIC_SHAPES \
+  {SQUARE(2), SQUARE(3), SQUARE(4), SQUARE(8), SQUARE(32), SQUARE(128), \
+   SQUARE(512)}
+
+static const bench_case_t cases[] = {
+    {"s21_create_matrix", run_create, ELEMENTWISE_SHAPES, no_flops,
+     one_matrix},
+    {"s21_eq_matrix", run_eq, ELEMENTWISE_SHAPES, elementwise_flops,
+     two_matrices},
+    {"s21_sum_matrix", run_sum, ELEMENTWISE_SHAPES, elementwise_flops,
+     three_matrices},
+    {"s21_sub_matrix", run_sub, ELEMENTWISE_SHAPES, elementwise_flops,
+     three_matrices},
+    {"s21_mult_number", run_mult_number, ELEMENTWISE_SHAPES,
+     elementwise_flops, two_matrices},
+    {"s21_mult_matrix",
+     run_mult_matrix,
+     {{4, 4, 4},
+      {16, 16, 16},
+      {64, 64, 64},
+      {256, 256, 256},
+      {1024, 1024, 1024},
+      {1024, 64, 1024},
+      {64, 1024, 64},
+      {4096, 4, 4096}},
+     product_flops,
+     product_bytes},
+    {"s21_transpose", run_transpose, ELEMENTWISE_SHAPES, no_flops,
+     two_matrices},
+    {"s21_calc_complements", run_complements, CUBIC_SHAPES, inverse_flops,
+     two_matrices},
+    {"s21_determinant", run_determinant, CUBIC_SHAPES, lu_flops, one_matrix},
+    {"s21_inverse_matrix", run_inverse, CUBIC_SHAPES, inverse_flops,
+     two_matrices},
+};
+
+static int compare_double(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+/*
+ * After a warmup that also sizes the batches, takes samples of ops calls
+ * each, SAMPLE_SECONDS or longer, until CASE_SECONDS have passed. Median
+ * and p99 (nearest rank) are per call.
+ */
+static bench_result_t measure(bench_fn run, bench_args_t *args) {
+  static double samples[MAX_SAMPLES];
+  bench_result_t r = {1, 0, 0.0, 0.0};
+  double start = now(), elapsed = 0.0;
+  int calls = 0;
+  while (elapsed < WARMUP_SECONDS || calls < 2) {
+    run(args);
+    calls++;
+    elapsed = now() - start;
+  }
+  r.ops = (int)(SAMPLE_SECONDS / (elapsed / calls)) + 1;
+  start = now();
+  while (r.samples < MAX_SAMPLES &&
+         (r.samples < MIN_SAMPLES || now() - start < CASE_SECONDS)) {
+    double t = now();
+    for (int i = 0; i < r.ops; i++) run(args);
+    samples[r.samples++] = (now() - t) / r.ops * 1e9;
+  }
+  qsort(samples, r.samples, sizeof(double), compare_double);
+  r.median_ns = samples[r.samples / 2];
+  r.p99_ns = samples[(r.samples * 99 + 99) / 100 - 1];
+  return r;
+}
+
+/* results of an earlier run, one per line as main writes them */
+static int read_baseline(const char *path, bench_baseline_t *b) {
+  FILE *f = fopen(path, "r");
+  char line[512];
+  int count = 0;
+  while (f && count < MAX_BASELINE && fgets(line, sizeof(line), f)) {
+    const char *median = strstr(line, "\"median_ns\": ");
+    if (median &&
+        sscanf(line,
+               " {\"function\": \"%63[^\"]\", \"rows\": %d, "
+               "\"columns\": %d, \"inner\": %d",
+               b[count].function, &b[count].rows, &b[count].columns,
+               &b[count].inner) == 4 &&
+        sscanf(median + strlen("\"median_ns\": "), "%lf",
+               &b[count].median_ns) == 1)
+      count++;
+  }
+  if (f) fclose(f);
+  return count;
+}
+
+static double baseline_ns(const bench_baseline_t *b, int count,
+                          const char *function, int m, int n, int k) {
+  double ret = 0.0;
+  for (int i = 0; i < count && ret == 0.0; i++) {
+    if (!strcmp(b[i].function, function) && b[i].rows == m &&
+        b[i].columns == n && b[i].inner == k)
+      ret = b[i].median_ns;
+  }
+  return ret;
+}
+
+/* usage: bench.out [result.json [baseline.json]] */
+int main(int argc, char **argv) {
+  static bench_baseline_t baseline[MAX_BASELINE];
+  const char *path = argc > 1 ? argv[1] : "bench.json";
+  int baselines = argc > 2 ? read_baseline(argv[2], baseline) : 0;
+  if (argc > 2 && !baselines) {
+    fprintf(stderr, "%s: no results to compare against\n", argv[2]);
+    return 1;
+  }
+  FILE *json = fopen(path, "w");
+  if (!json) {
+    perror(path);
+    return 1;
+  }
+  fprintf(json,
+          "{\n  \"unix_time\": %lld,\n  \"threads\": %d,\n"
+          "  \"isa_level\": %d,\n",
+          (long long)time(NULL), s21_get_num_threads(), s21_isa_level());
+  fprintf(json, "  \"results\": [");
+  printf("threads: %d (S21_NUM_THREADS), isa level: %d (S21_MATRIX_ISA)\n",
+         s21_get_num_threads(), s21_isa_level());
+  printf("%-22s %14s %12s %12s %9s %10s%s\n", "function", "shape",
+         "median ns", "p99 ns", "GFLOPS", "GB/s", baselines ? "  speedup" : "");
+  int first = 1, compared = 0;
+  double log_speedup = 0.0;
+  for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+    for (int s = 0; s < 8 && cases[c].shapes[s][0]; s++) {
+      int m = cases[c].shapes[s][0], n = cases[c].shapes[s][1],
+          k = cases[c].shapes[s][2];
+      bench_args_t args = {0};
+      s21_create_matrix(m, k ? k : n, &args.a);
+      s21_create_matrix(k ? k : m, n, &args.b);
+      srand(1);
+      fill_random(&args.a);
+      srand(1);
+      fill_random(&args.b);
+      bench_result_t r = measure(cases[c].run, &args);
+      double flops = cases[c].flops(m, n, k ? k : n);
+      double bytes = cases[c].bytes(m, n, k ? k : n);
+      char shape[32];
+      if (k)
+        snprintf(shape, sizeof(shape), "%dx%dx%d", m, k, n);
+      else
+        snprintf(shape, sizeof(shape), "%dx%d", m, n);
+      double base = baseline_ns(baseline, baselines, cases[c].name, m, n, k);
+      printf("%-22s %14s %12.0f %12.0f %9.2f %10.2f", cases[c].name, shape,
+             r.median_ns, r.p99_ns, flops / r.median_ns, bytes / r.median_ns);
+      if (base > 0.0) {
+        printf(" %8.2fx", base / r.median_ns);
+        log_speedup += log(base / r.median_ns);
+        compared++;
+      }
+      printf("\n");
+      fprintf(json,
+              "%s\n    {\"function\": \"%s\", \"rows\": %d, \"columns\": %d, "
+              "\"inner\": %d, \"ops_per_sample\": %d, \"samples\": %d, "
+              "\"median_ns\": %.1f, \"p99_ns\": %.1f, \"gflops\": %.4f, "
+              "\"bytes_per_s\": %.0f}",
+              first ? "" : ",", cases[c].name, m, n, k, r.ops, r.samples,
+              r.median_ns, r.p99_ns, flops / r.median_ns,
+              bytes / r.median_ns * 1e9);
+      first = 0;
+      s21_remove_matrix(&args.a);
+      s21_remove_matrix(&args.b);
+    }
+  }
+  fprintf(json, "\n  ]\n}\n");
+  fclose(json);
+  if (compared)
+    printf("geometric mean speedup over %s: %.2fx (%d cases)\n", argv[2],
+           exp(log_speedup / compared), compared);
+  printf("results written to %s\n", path);
+  return 0;
+}
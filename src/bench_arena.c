@@ -0,0 +1,141 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "s21_matrix.h"
+
+#define OPS 2000
+
+/* heap calls are counted through -Wl,--wrap=malloc,... */
+static long allocations;
+
+void *__real_malloc(size_t);
+void *__real_calloc(size_t, size_t);
+void *__real_aligned_alloc(size_t, size_t);
+
+void *__wrap_malloc(size_t n) {
+  __atomic_add_fetch(&allocations, 1, __ATOMIC_RELAXED);
+  return __real_malloc(n);
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+  __atomic_add_fetch(&allocations, 1, __ATOMIC_RELAXED);
+  return __real_calloc(n, size);
+}
+
+void *__wrap_aligned_alloc(size_t align, size_t n) {
+  __atomic_add_fetch(&allocations, 1, __ATOMIC_RELAXED);
+  return __real_aligned_alloc(align, n);
+}
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+typedef struct {
+  const char *name;
+  int n;
+  double seconds;
+} job_t;
+
+static void run_op(const char *name, matrix_t *a) {
+  matrix_t r = {0};
+  double det = 0;
+  if (name[0] == 'd') s21_determinant(a, &det);
+  if (name[0] == 'i') s21_inverse_matrix_into(a, &r);
+  if (name[0] == 'c') s21_calc_complements_into(a, &r);
+  s21_remove_matrix(&r);
+}
+
+/* create/remove of heap matrices while other threads hold arena chunks */
+static void *remover(void *arg) {
+  job_t *job = arg;
+  double start = now();
+  for (int k = 0; k < OPS * 50; k++) {
+    matrix_t r;
+    s21_create_matrix(job->n, job->n, &r);
+    s21_remove_matrix(&r);
+  }
+  job->seconds = (now() - start) / 50;
+  return NULL;
+}
+
+static void *worker(void *arg) {
+  job_t *job = arg;
+  matrix_t a;
+  s21_create_matrix(job->n, job->n, &a);
+  for (int i = 0; i < job->n; i++) {
+    for (int j = 0; j < job->n; j++) a.matrix[i][j] = (i * 7 + j * 3) % 11;
+    a.matrix[i][i] += job->n * 11;
+  }
+  run_op(job->name, &a);
+  double start = now();
+  for (int k = 0; k < OPS; k++) run_op(job->name, &a);
+  job->seconds = now() - start;
+  s21_remove_matrix(&a);
+  return NULL;
+}
+
+int main(void) {
+  const char *ops[] = {"determinant", "inverse", "complements"};
+  int sizes[] = {4, 16, 64};
+  int threads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (threads > 16) threads = 16;
+  const char *arena = getenv("S21_MATRIX_ARENA");
+  printf("arena %s, %d threads in the parallel column\n",
+         arena && arena[0] == '0' ? "off" : "on", threads);
+  printf("%-12s %4s %12s %14s %14s\n", "op", "n", "allocs/op", "1 thread ns",
+         "N threads ns");
+  for (int o = 0; o < 3; o++) {
+    for (int s = 0; s < 3; s++) {
+      job_t job = {ops[o], sizes[s], 0};
+      long before = allocations;
+      worker(&job);
+      double allocs = (double)(allocations - before) / (OPS + 1);
+      job_t jobs[16];
+      pthread_t tid[16];
+      for (int t = 0; t < threads; t++) {
+        jobs[t] = job;
+        pthread_create(tid + t, NULL, worker, jobs + t);
+      }
+      double worst = 0;
+      for (int t = 0; t < threads; t++) {
+        pthread_join(tid[t], NULL);
+        if (jobs[t].seconds > worst) worst = jobs[t].seconds;
+      }
+      printf("%-12s %4d %12.2f %14.0f %14.0f\n", ops[o], sizes[s], allocs,
+             job.seconds / OPS * 1e9, worst / OPS * 1e9);
+    }
+  }
+  /* a parallel product leaves arena chunks with the pool workers */
+  matrix_t a, c;
+  s21_create_matrix(512, 512, &a);
+  s21_set_num_threads(threads);
+  s21_mult_matrix(&a, &a, &c);
+  s21_remove_matrix(&c);
+  s21_remove_matrix(&a);
+  job_t job = {"remove", 3, 0};
+  long before = allocations;
+  remover(&job);
+  double allocs = (double)(allocations - before) / (OPS * 50);
+  job_t jobs[16];
+  pthread_t tid[16];
+  for (int t = 0; t < threads; t++) {
+    jobs[t] = job;
+    pthread_create(tid + t, NULL, remover, jobs + t);
+  }
+  double worst = 0;
+  for (int t = 0; t < threads; t++) {
+    pthread_join(tid[t], NULL);
+    if (jobs[t].seconds > worst) worst = jobs[t].seconds;
+  }
+  printf("%-12s %4d %12.2f %14.0f %14.0f\n", job.name, job.n, allocs,
+         job.seconds / OPS * 1e9, worst / OPS * 1e9);
+  return 0;
+}
@@ -0,0 +1,101 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "s21_matrix.h"
+
+#define MIN_SIZE 64
+#define MAX_SIZE 4096
+#define NAIVE_MAX_SIZE 1024
+#define MIN_SECONDS 0.5
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void naive_mult(matrix_t *a, matrix_t *b, matrix_t *result) {
+  s21_create_matrix(a->rows, b->columns, result);
+  for (int i = 0; i < a->rows; i++) {
+    for (int j = 0; j < b->columns; j++) {
+      for (int r = 0; r < b->rows; r++) {
+        result->matrix[i][j] += a->matrix[i][r] * b->matrix[r][j];
+      }
+    }
+  }
+}
+
+static void fill_random(matrix_t *a) {
+  for (int i = 0; i < a->rows; i++) {
+    for (int j = 0; j < a->columns; j++) {
+      a->matrix[i][j] = rand() / (double)RAND_MAX - 0.5;
+    }
+  }
+}
+
+/* best time of repeated runs, at least MIN_SECONDS in total */
+static double time_mult(void (*mult)(matrix_t *, matrix_t *, matrix_t *),
+                        matrix_t *a, matrix_t *b, matrix_t *result) {
+  double best = INFINITY, total = 0.0;
+  int runs = 0;
+  while (runs < 3 || (total < MIN_SECONDS && runs < 1000)) {
+    double start = now();
+    mult(a, b, result);
+    double elapsed = now() - start;
+    s21_remove_matrix(result);
+    total += elapsed;
+    if (elapsed < best) best = elapsed;
+    runs++;
+  }
+  mult(a, b, result);
+  return best;
+}
+
+static void s21_mult(matrix_t *a, matrix_t *b, matrix_t *result) {
+  s21_mult_matrix(a, b, result);
+}
+
+static double max_diff(matrix_t *a, matrix_t *b) {
+  double diff = 0.0;
+  for (int i = 0; i < a->rows; i++) {
+    for (int j = 0; j < a->columns; j++) {
+      double d = fabs(a->matrix[i][j] - b->matrix[i][j]);
+      if (d > diff) diff = d;
+    }
+  }
+  return diff;
+}
+
+int main(int argc, char **argv) {
+  int naive_max = argc > 1 ? atoi(argv[1]) : NAIVE_MAX_SIZE;
+  int max = argc > 2 ? atoi(argv[2]) : MAX_SIZE;
+  printf("threads: %d (S21_NUM_THREADS)\n", s21_get_num_threads());
+  printf("%6s %14s %14s %9s %10s\n", "n", "naive GFLOPS", "s21 GFLOPS",
+         "speedup", "max diff");
+  for (int n = MIN_SIZE; n <= max; n *= 2) {
+    matrix_t a, b, fast, slow = {0};
+    s21_create_matrix(n, n, &a);
+    s21_create_matrix(n, n, &b);
+    fill_random(&a);
+    fill_random(&b);
+    double flops = 2.0 * n * n * n;
+    double t_fast = time_mult(s21_mult, &a, &b, &fast);
+    printf("%6d ", n);
+    if (n <= naive_max) {
+      double t_slow = time_mult(naive_mult, &a, &b, &slow);
+      printf("%14.2f %14.2f %8.1fx %10.2e\n", flops / t_slow * 1e-9,
+             flops / t_fast * 1e-9, t_slow / t_fast, max_diff(&fast, &slow));
+    } else {
+      printf("%14s %14.2f %9s %10s\n", "-", flops / t_fast * 1e-9, "-", "-");
+    }
+    s21_remove_matrix(&a);
+    s21_remove_matrix(&b);
+    s21_remove_matrix(&fast);
+    s21_remove_matrix(&slow);
+  }
+  return 0;
+}
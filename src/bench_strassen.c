@@ -0,0 +1,94 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "s21_matrix.h"
+
+#define MIN_SIZE 512
+#define MAX_SIZE 4096
+#define MIN_SECONDS 0.5
+
+static const int cutoffs[] = {0, 128, 192, 256, 384, 512, 768, 1024};
+#define CUTOFFS ((int)(sizeof(cutoffs) / sizeof(cutoffs[0])))
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void fill_random(matrix_t *a) {
+  for (int i = 0; i < a->rows; i++) {
+    for (int j = 0; j < a->columns; j++) {
+      a->matrix[i][j] = rand() / (double)RAND_MAX - 0.5;
+    }
+  }
+}
+
+/* best time of repeated runs, at least MIN_SECONDS in total */
+static double time_mult(matrix_t *a, matrix_t *b, matrix_t *result) {
+  double best = INFINITY, total = 0.0;
+  int runs = 0;
+  while (runs < 2 || (total < MIN_SECONDS && runs < 100)) {
+    double start = now();
+    s21_mult_matrix_into(a, b, result);
+    double elapsed = now() - start;
+    total += elapsed;
+    if (elapsed < best) best = elapsed;
+    runs++;
+  }
+  return best;
+}
+
+static double max_diff(matrix_t *a, matrix_t *b) {
+  double diff = 0.0;
+  for (int i = 0; i < a->rows; i++) {
+    for (int j = 0; j < a->columns; j++) {
+      double d = fabs(a->matrix[i][j] - b->matrix[i][j]);
+      if (d > diff) diff = d;
+    }
+  }
+  return diff;
+}
+
+/*
+ * Times every cutoff against plain GEMM and suggests the one with the
+ * lowest total time relative to GEMM; GFLOPS count the classical 2n^3.
+ */
+int main(int argc, char **argv) {
+  int max = argc > 1 ? atoi(argv[1]) : MAX_SIZE;
+  double score[CUTOFFS] = {0};
+  printf("threads: %d (S21_NUM_THREADS)\n", s21_get_num_threads());
+  printf("%6s %8s %10s %9s %10s\n", "n", "cutoff", "GFLOPS", "speedup",
+         "max diff");
+  for (int n = MIN_SIZE; n <= max; n *= 2) {
+    matrix_t a, b, plain = {0}, fast = {0};
+    s21_create_matrix(n, n, &a);
+    s21_create_matrix(n, n, &b);
+    fill_random(&a);
+    fill_random(&b);
+    double flops = 2.0 * n * n * n, base = 0.0;
+    for (int c = 0; c < CUTOFFS; c++) {
+      s21_set_strassen_cutoff(cutoffs[c]);
+      matrix_t *result = c == 0 ? &plain : &fast;
+      double t = time_mult(&a, &b, result);
+      if (c == 0) base = t;
+      score[c] += t / base;
+      printf("%6d %8d %10.2f %8.2fx %10.2e\n", n, cutoffs[c], flops / t * 1e-9,
+             base / t, max_diff(result, &plain));
+    }
+    s21_remove_matrix(&a);
+    s21_remove_matrix(&b);
+    s21_remove_matrix(&plain);
+    s21_remove_matrix(&fast);
+  }
+  int best = 0;
+  for (int c = 1; c < CUTOFFS; c++) {
+    if (score[c] < score[best]) best = c;
+  }
+  printf("suggested: S21_STRASSEN_CUTOFF=%d\n", cutoffs[best]);
+  return 0;
+}
@@ -0,0 +1,76 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "s21_matrix.h"
+
+#define MIN_SIZE 512
+#define MAX_SIZE 8192
+#define MIN_SECONDS 0.5
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void naive_transpose(matrix_t *a, matrix_t *result) {
+  for (int i = 0; i < a->rows; i++) {
+    for (int j = 0; j < a->columns; j++) {
+      result->matrix[j][i] = a->matrix[i][j];
+    }
+  }
+}
+
+static void s21_out_of_place(matrix_t *a, matrix_t *result) {
+  s21_transpose_into(a, result);
+}
+
+static void s21_in_place(matrix_t *a, matrix_t *result) {
+  (void)result;
+  s21_transpose_inplace(a);
+}
+
+/* best time of repeated runs, at least MIN_SECONDS in total */
+static double time_transpose(void (*transpose)(matrix_t *, matrix_t *),
+                             matrix_t *a, matrix_t *result) {
+  double best = INFINITY, total = 0.0;
+  int runs = 0;
+  while (runs < 3 || (total < MIN_SECONDS && runs < 1000)) {
+    double start = now();
+    transpose(a, result);
+    double elapsed = now() - start;
+    total += elapsed;
+    if (elapsed < best) best = elapsed;
+    runs++;
+  }
+  return best;
+}
+
+/* bandwidth counts one read and one write of every element */
+int main(int argc, char **argv) {
+  int max = argc > 1 ? atoi(argv[1]) : MAX_SIZE;
+  printf("threads: %d (S21_NUM_THREADS)\n", s21_get_num_threads());
+  printf("%6s %12s %12s %12s\n", "n", "naive GB/s", "s21 GB/s",
+         "inplace GB/s");
+  for (int n = MIN_SIZE; n <= max; n *= 2) {
+    matrix_t a, result;
+    s21_create_matrix(n, n, &a);
+    s21_create_matrix(n, n, &result);
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) a.matrix[i][j] = rand() / (double)RAND_MAX;
+    }
+    double bytes = 2.0 * n * n * sizeof(double);
+    double t_naive = time_transpose(naive_transpose, &a, &result);
+    double t_fast = time_transpose(s21_out_of_place, &a, &result);
+    double t_inplace = time_transpose(s21_in_place, &a, &result);
+    printf("%6d %12.2f %12.2f %12.2f\n", n, bytes / t_naive * 1e-9,
+           bytes / t_fast * 1e-9, bytes / t_inplace * 1e-9);
+    s21_remove_matrix(&a);
+    s21_remove_matrix(&result);
+  }
+  return 0;
+}
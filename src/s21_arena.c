@@ -0,0 +1,263 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "s21_internal.h"
+
+#define S21_CHUNK_MIN (8u << 20)
+
+/*
+ * Address range of a live chunk of any thread, read without locks so that
+ * another thread can recognise an arena block handed to it. Ranges are
+ * never freed, only reused, and seq is odd while one is being rewritten.
+ */
+typedef struct s21_range {
+  atomic_uintptr_t start;
+  atomic_size_t size;
+  atomic_uint seq;
+  atomic_int in_use;
+  struct s21_range *next;
+} s21_range_t;
+
+typedef struct s21_chunk {
+  struct s21_chunk *next;
+  s21_range_t *range;
+  size_t size;
+  size_t used;
+} s21_chunk_t;
+
+typedef struct {
+  s21_chunk_t *head;
+  s21_chunk_t *current;
+  size_t chunks_allocated;
+  int live;
+} s21_arena_t;
+
+static _Thread_local s21_arena_t s21_arena;
+static pthread_key_t s21_arena_key;
+static pthread_once_t s21_arena_once = PTHREAD_ONCE_INIT;
+static int s21_arena_enabled = TRUE;
+
+static _Atomic(s21_range_t *) s21_ranges;
+/* chunks of all threads; the caller's own count means no one else has any */
+static atomic_int s21_chunks_live;
+
+static void s21_range_set(s21_range_t *r, uintptr_t start, size_t size) {
+  atomic_fetch_add(&r->seq, 1);
+  atomic_store(&r->start, start);
+  atomic_store(&r->size, size);
+  atomic_fetch_add(&r->seq, 1);
+}
+
+/* a free range from the list, or a new one pushed onto it */
+static s21_range_t *s21_range_claim(void) {
+  s21_range_t *r = atomic_load(&s21_ranges);
+  int idle = FALSE;
+  while (r && !atomic_compare_exchange_strong(&r->in_use, &idle, TRUE)) {
+    idle = FALSE;
+    r = r->next;
+  }
+  if (!r && (r = calloc(1, sizeof(s21_range_t)))) {
+    atomic_init(&r->in_use, TRUE);
+    r->next = atomic_load(&s21_ranges);
+    while (!atomic_compare_exchange_weak(&s21_ranges, &r->next, r)) {
+    }
+  }
+  return r;
+}
+
+static int s21_range_holds(s21_range_t *r, uintptr_t p) {
+  unsigned seq;
+  uintptr_t start;
+  size_t size;
+  do {
+    seq = atomic_load(&r->seq);
+    start = atomic_load(&r->start);
+    size = atomic_load(&r->size);
+  } while (seq % 2 || seq != atomic_load(&r->seq));
+  return p >= start && p - start < size;
+}
+
+static void s21_arena_free_chunks(s21_arena_t *arena, s21_chunk_t *chunk) {
+  while (chunk) {
+    s21_chunk_t *next = chunk->next;
+    s21_range_set(chunk->range, 0, 0);
+    atomic_store(&chunk->range->in_use, FALSE);
+    atomic_fetch_sub(&s21_chunks_live, 1);
+    arena->live--;
+    free(chunk);
+    chunk = next;
+  }
+}
+
+static void s21_arena_thread_exit(void *arena) {
+  s21_arena_free_chunks(arena, ((s21_arena_t *)arena)->head);
+}
+
+static void s21_arena_make_key(void) {
+  pthread_key_create(&s21_arena_key, s21_arena_thread_exit);
+}
+
+static size_t s21_chunk_header(void) {
+  return (sizeof(s21_chunk_t) + S21_ALIGN - 1) / S21_ALIGN * S21_ALIGN;
+}
+
+static s21_chunk_t *s21_chunk_new(size_t bytes) {
+  size_t size = bytes < S21_CHUNK_MIN ? S21_CHUNK_MIN : bytes;
+  size = (size + S21_ALIGN - 1) / S21_ALIGN * S21_ALIGN;
+  s21_chunk_t *chunk = NULL;
+  s21_range_t *range = NULL;
+  if (size >= bytes && size <= SIZE_MAX - s21_chunk_header())
+    chunk = aligned_alloc(S21_ALIGN, s21_chunk_header() + size);
+  if (chunk && !(range = s21_range_claim())) {
+    free(chunk);
+    chunk = NULL;
+  }
+  if (chunk) {
+    chunk->next = NULL;
+    chunk->range = range;
+    chunk->size = size;
+    chunk->used = 0;
+    s21_range_set(range, (uintptr_t)chunk + s21_chunk_header(), size);
+    atomic_fetch_add(&s21_chunks_live, 1);
+    s21_arena.chunks_allocated++;
+    s21_arena.live++;
+    if (!s21_arena.head) {
+      pthread_once(&s21_arena_once, s21_arena_make_key);
+      pthread_setspecific(s21_arena_key, &s21_arena);
+    }
+  }
+  return chunk;
+}
+
+s21_arena_mark_t s21_arena_begin(void) {
+  s21_arena_mark_t mark = {s21_arena.current,
+                           s21_arena.current ? s21_arena.current->used : 0};
+  return mark;
+}
+
+void s21_arena_end(s21_arena_mark_t mark) {
+  s21_arena.current = mark.chunk ? mark.chunk : s21_arena.head;
+  if (s21_arena.current) s21_arena.current->used = mark.used;
+}
+
+/* chunks past the current one are spares, reused before asking malloc */
+void *s21_arena_alloc(size_t bytes) {
+  s21_chunk_t *c = s21_arena.current;
+  size_t offset = c ? (c->used + S21_ALIGN - 1) / S21_ALIGN * S21_ALIGN : 0;
+  if (!c || offset > c->size || bytes > c->size - offset) {
+    s21_chunk_t *next = c ? c->next : s21_arena.head;
+    if (!next || next->size < bytes) {
+      s21_chunk_t *fresh = s21_chunk_new(bytes);
+      if (fresh) {
+        s21_arena_free_chunks(&s21_arena, next);
+        if (c)
+          c->next = fresh;
+        else
+          s21_arena.head = fresh;
+      }
+      next = fresh;
+    }
+    c = next;
+    offset = 0;
+    if (c) {
+      c->used = 0;
+      s21_arena.current = c;
+    }
+  }
+  void *ret = NULL;
+  if (c) {
+    ret = (char *)c + s21_chunk_header() + offset;
+    c->used = offset + bytes;
+    S21_STATS_ALLOC(bytes);
+  }
+  return ret;
+}
+
+static int s21_chunk_holds(const s21_chunk_t *c, const void *p) {
+  const char *data = (const char *)c + s21_chunk_header();
+  return (const char *)p >= data && (const char *)p < data + c->size;
+}
+
+static int s21_arena_owns_local(const void *p) {
+  int ret = FALSE;
+  for (s21_chunk_t *c = s21_arena.head; c && !ret; c = c->next)
+    ret = s21_chunk_holds(c, p);
+  return ret;
+}
+
+/* the caller's chunks first, then the ranges of other threads' chunks */
+int s21_arena_owns(const void *p) {
+  int ret = s21_arena_owns_local(p);
+  if (!ret && atomic_load(&s21_chunks_live) > s21_arena.live) {
+    for (s21_range_t *r = atomic_load(&s21_ranges); r && !ret; r = r->next)
+      ret = s21_range_holds(r, (uintptr_t)p);
+  }
+  return ret;
+}
+
+void s21_arena_release(void) {
+  s21_arena_free_chunks(&s21_arena, s21_arena.head);
+  s21_arena.head = s21_arena.current = NULL;
+}
+
+size_t s21_arena_chunks_allocated(void) { return s21_arena.chunks_allocated; }
+
+int s21_arena_create_matrix(int rows, int columns, matrix_t *result) {
+  int ret = OK;
+  size_t bytes = rows > 0 && columns > 0 && columns <= INT_MAX - S21_ALIGN
+                     ? s21_block_bytes(rows, columns)
+                     : 0;
+  double **matrix = bytes && result ? s21_arena_alloc(bytes) : NULL;
+  if (matrix) {
+    memset(s21_matrix_data(matrix, rows), 0,
+           bytes - s21_row_table_bytes(rows));
+    s21_layout_rows(matrix, rows, columns);
+    result->matrix = matrix;
+    result->rows = rows;
+    result->columns = columns;
+  } else {
+    ret = ERROR;
+  }
+  return ret;
+}
+
+void *s21_scratch_alloc(size_t bytes) {
+  S21_STATS_TEMPORARY();
+  if (!s21_arena_enabled) S21_STATS_ALLOC(bytes);
+  return s21_arena_enabled
+             ? s21_arena_alloc(bytes)
+             : aligned_alloc(S21_ALIGN, (bytes + S21_ALIGN - 1) / S21_ALIGN *
+                                            S21_ALIGN);
+}
+
+/* scratch never leaves the thread that took it */
+void s21_scratch_free(void *p) {
+  if (!s21_arena_owns_local(p)) free(p);
+}
+
+int s21_scratch_matrix(int rows, int columns, matrix_t *result) {
+  S21_STATS_TEMPORARY();
+  return s21_arena_enabled ? s21_arena_create_matrix(rows, columns, result)
+                           : s21_create_matrix(rows, columns, result);
+}
+
+matrix_t s21_scratch_copy(matrix_t *a) {
+  matrix_t ret = {0};
+  if (s21_scratch_matrix(a->rows, a->columns, &ret) == OK) {
+    for (int i = 0; i < a->rows; i++) {
+      memcpy(ret.matrix[i], a->matrix[i], a->columns * sizeof(double));
+    }
+  }
+  return ret;
+}
+
+/* S21_MATRIX_ARENA=0 sends internal temporaries back to malloc for A/B runs */
+__attribute__((constructor)) static void s21_arena_init(void) {
+  const char *env = getenv("S21_MATRIX_ARENA");
+  if (env && strcmp(env, "0") == 0) s21_arena_enabled = FALSE;
+}
@@ -0,0 +1,554 @@
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#include "s21_internal.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define S21_X86 1
+#endif
+
+#define S21_BATCH_SOA_MAX (16 * 16 * 16)
+#define S21_BATCH_SQUARE_MAX 16
+#define S21_BATCH_TASK 64
+
+/* element (i, j) of every lane of an interleaved n-column buffer */
+#define S21_LANE(buf, n, i, j) ((buf) + ((i) * (n) + (j)) * S21_BATCH_LANES)
+
+/* operands are either matrix_t arrays or strided row-major buffers */
+typedef struct {
+  matrix_t *ma, *mb, *mc;
+  const double *a, *b;
+  double *c;
+  size_t sa, sb, sc;
+  int m, n, k, count;
+  double *det;
+  int *singular;
+} s21_batch_t;
+
+static const double *s21_batch_a(const s21_batch_t *job, int l, int i) {
+  return job->ma ? job->ma[l].matrix[i] : job->a + job->sa * l + job->k * i;
+}
+
+static const double *s21_batch_b(const s21_batch_t *job, int l, int p) {
+  return job->mb ? job->mb[l].matrix[p] : job->b + job->sb * l + job->n * p;
+}
+
+static double *s21_batch_c(const s21_batch_t *job, int l, int i) {
+  return job->mc ? job->mc[l].matrix[i] : job->c + job->sc * l + job->n * i;
+}
+
+/* one SoA pass over lanes first..first + S21_BATCH_LANES, tail zero filled */
+static inline __attribute__((always_inline)) void s21_batch_lanes(
+    const s21_batch_t *job, int first, double *buf, int m, int n, int k) {
+  int lanes = job->count - first;
+  double *as = buf, *bs = as + m * k * S21_BATCH_LANES,
+         *cs = bs + k * n * S21_BATCH_LANES;
+  if (lanes > S21_BATCH_LANES) lanes = S21_BATCH_LANES;
+  if (lanes < S21_BATCH_LANES)
+    memset(buf, 0, sizeof(double) * (m * k + k * n) * S21_BATCH_LANES);
+  for (int l = 0; l < lanes; l++) {
+    for (int i = 0; i < m; i++) {
+      const double *row = s21_batch_a(job, first + l, i);
+      for (int p = 0; p < k; p++)
+        as[(i * k + p) * S21_BATCH_LANES + l] = row[p];
+    }
+    for (int p = 0; p < k; p++) {
+      const double *row = s21_batch_b(job, first + l, p);
+      for (int j = 0; j < n; j++)
+        bs[(p * n + j) * S21_BATCH_LANES + l] = row[j];
+    }
+  }
+  s21_kernels->mult_soa(m, n, k, as, bs, cs);
+  for (int l = 0; l < lanes; l++) {
+    for (int i = 0; i < m; i++) {
+      double *row = s21_batch_c(job, first + l, i);
+      for (int j = 0; j < n; j++)
+        row[j] = cs[(i * n + j) * S21_BATCH_LANES + l];
+    }
+  }
+}
+
+/* constant sizes let the compiler unroll the short gather loops */
+static void s21_batch_group(const s21_batch_t *job, int first, double *buf) {
+  int m = job->m, n = job->n, k = job->k;
+  if (m == n && n == k && m == 2)
+    s21_batch_lanes(job, first, buf, 2, 2, 2);
+  else if (m == n && n == k && m == 3)
+    s21_batch_lanes(job, first, buf, 3, 3, 3);
+  else if (m == n && n == k && m == 4)
+    s21_batch_lanes(job, first, buf, 4, 4, 4);
+  else if (m == n && n == k && m == 6)
+    s21_batch_lanes(job, first, buf, 6, 6, 6);
+  else
+    s21_batch_lanes(job, first, buf, m, n, k);
+}
+
+/* shapes too big for SoA go one by one, via tmp when c shares an operand */
+static void s21_batch_single(const s21_batch_t *job, int l, double **t,
+                             matrix_t *tmp) {
+  int shared = job->mc && (job->mc[l].matrix == job->ma[l].matrix ||
+                           job->mc[l].matrix == job->mb[l].matrix);
+  double **c = t + job->m + job->k;
+  for (int i = 0; i < job->m; i++) {
+    t[i] = (double *)s21_batch_a(job, l, i);
+    c[i] = shared ? tmp->matrix[i] : s21_batch_c(job, l, i);
+    memset(c[i], 0, sizeof(double) * job->n);
+  }
+  for (int p = 0; p < job->k; p++)
+    t[job->m + p] = (double *)s21_batch_b(job, l, p);
+  s21_gemm(job->m, job->n, job->k, 1.0, t, t + job->m, c);
+  for (int i = 0; i < job->m && shared; i++)
+    memcpy(s21_batch_c(job, l, i), c[i], sizeof(double) * job->n);
+}
+
+/* a task covers S21_BATCH_TASK lane groups */
+static void s21_batch_task(void *ctx, int task) {
+  const s21_batch_t *job = ctx;
+  int m = job->m, n = job->n, k = job->k;
+  int first = task * S21_BATCH_TASK * S21_BATCH_LANES;
+  int last = first + S21_BATCH_TASK * S21_BATCH_LANES;
+  if (last > job->count) last = job->count;
+  s21_arena_mark_t mark = s21_arena_begin();
+  if ((double)m * n * k <= S21_BATCH_SOA_MAX) {
+    double *buf = s21_scratch_alloc(sizeof(double) * S21_BATCH_LANES *
+                                    (m * k + k * n + m * n));
+    for (int l = first; l < last && buf; l += S21_BATCH_LANES)
+      s21_batch_group(job, l, buf);
+    s21_scratch_free(buf);
+  } else {
+    double **t = s21_scratch_alloc(sizeof(double *) * (2 * m + k));
+    matrix_t tmp = {0};
+    int ok = t && s21_scratch_matrix(m, n, &tmp) == OK;
+    for (int l = first; l < last && ok; l++) s21_batch_single(job, l, t, &tmp);
+    s21_remove_matrix(&tmp);
+    s21_scratch_free(t);
+  }
+  s21_arena_end(mark);
+}
+
+static void s21_batch_run(s21_batch_t *job, void (*task)(void *, int)) {
+  int group = S21_BATCH_TASK * S21_BATCH_LANES;
+  s21_parallel_for((job->count + group - 1) / group, task, job);
+}
+
+/* ERROR unless all count matrices are valid and shaped like the first */
+static int s21_batch_check(matrix_t *a, int count) {
+  int ret = OK;
+  for (int l = 0; l < count && ret == OK; l++) {
+    if (!s21_is_valid_matrix_t(&a[l]) || !s21_equal_dims(&a[l], &a[0]))
+      ret = ERROR;
+  }
+  return ret;
+}
+
+/* a result aliasing its own operand cannot be reshaped under it */
+static int s21_batch_reserve(matrix_t *result, int rows, int columns,
+                             matrix_t *a, matrix_t *b, int count) {
+  int ret = OK;
+  for (int l = 0; l < count && ret == OK; l++) {
+    int shared = s21_is_valid_matrix_t(&result[l]) &&
+                 (result[l].matrix == a[l].matrix ||
+                  (b && result[l].matrix == b[l].matrix));
+    if (shared && (result[l].rows != rows || result[l].columns != columns))
+      ret = ERROR;
+    else
+      ret = s21_reserve_matrix(rows, columns, &result[l]);
+  }
+  return ret;
+}
+
+/*
+ * Square kernels over S21_BATCH_LANES interleaved n x n matrices. They are
+ * written as plain loops over lanes and compiled once per ISA level, so the
+ * vectoriser turns each lane loop into a few wide instructions.
+ */
+typedef struct {
+  double det[S21_BATCH_LANES];
+  double tol[S21_BATCH_LANES];
+  int singular[S21_BATCH_LANES];
+} s21_lanes_t;
+
+/* pivots at or below n * DBL_EPSILON * max|a| count as zero, as in LU */
+static inline __attribute__((always_inline)) void s21_lanes_tol(
+    int n, const double *a, s21_lanes_t *r) {
+  for (int l = 0; l < S21_BATCH_LANES; l++) r->tol[l] = 0.0;
+  for (int e = 0; e < n * n; e++) {
+    for (int l = 0; l < S21_BATCH_LANES; l++) {
+      double v = fabs(a[e * S21_BATCH_LANES + l]);
+      r->tol[l] = v > r->tol[l] ? v : r->tol[l];
+    }
+  }
+  for (int l = 0; l < S21_BATCH_LANES; l++) r->tol[l] *= n * DBL_EPSILON;
+}
+
+/* closed forms flag |det| <= tol * max|a|^(n - 1) */
+static inline __attribute__((always_inline)) void s21_lanes_flag(
+    int n, s21_lanes_t *r) {
+  for (int l = 0; l < S21_BATCH_LANES; l++) {
+    double scale = r->tol[l] / (n * DBL_EPSILON), bound = r->tol[l];
+    for (int i = 1; i < n; i++) bound *= scale;
+    r->singular[l] = fabs(r->det[l]) <= bound;
+  }
+}
+
+static inline __attribute__((always_inline)) void s21_lanes_2x2(
+    const double *a, double *inv, s21_lanes_t *r) {
+  for (int l = 0; l < S21_BATCH_LANES; l++) {
+    double a00 = S21_LANE(a, 2, 0, 0)[l], a01 = S21_LANE(a, 2, 0, 1)[l];
+    double a10 = S21_LANE(a, 2, 1, 0)[l], a11 = S21_LANE(a, 2, 1, 1)[l];
+    double det = a00 * a11 - a01 * a10, rcp = 1.0 / det;
+    r->det[l] = det;
+    if (inv) {
+      S21_LANE(inv, 2, 0, 0)[l] = a11 * rcp;
+      S21_LANE(inv, 2, 0, 1)[l] = -a01 * rcp;
+      S21_LANE(inv, 2, 1, 0)[l] = -a10 * rcp;
+      S21_LANE(inv, 2, 1, 1)[l] = a00 * rcp;
+    }
+  }
+}
+
+/* the adjugate is the transposed cofactor matrix */
+static inline __attribute__((always_inline)) void s21_lanes_3x3(
+    const double *a, double *inv, s21_lanes_t *r) {
+  for (int l = 0; l < S21_BATCH_LANES; l++) {
+    double m[3][3], c[3][3];
+    for (int i = 0; i < 3; i++)
+      for (int j = 0; j < 3; j++) m[i][j] = S21_LANE(a, 3, i, j)[l];
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 3; j++) {
+        int i1 = (i + 1) % 3, i2 = (i + 2) % 3, j1 = (j + 1) % 3,
+            j2 = (j + 2) % 3;
+        c[i][j] = m[i1][j1] * m[i2][j2] - m[i1][j2] * m[i2][j1];
+      }
+    }
+    double det = m[0][0] * c[0][0] + m[0][1] * c[0][1] + m[0][2] * c[0][2];
+    double rcp = 1.0 / det;
+    r->det[l] = det;
+    for (int i = 0; i < 3 && inv; i++)
+      for (int j = 0; j < 3; j++) S21_LANE(inv, 3, j, i)[l] = c[i][j] * rcp;
+  }
+}
+
+/* Laplace expansion along the 2x2 minors of the top and bottom row pairs */
+static inline __attribute__((always_inline)) void s21_lanes_4x4(
+    const double *a, double *inv, s21_lanes_t *r) {
+  for (int l = 0; l < S21_BATCH_LANES; l++) {
+    double m[4][4];
+    for (int i = 0; i < 4; i++)
+      for (int j = 0; j < 4; j++) m[i][j] = S21_LANE(a, 4, i, j)[l];
+    double s0 = m[0][0] * m[1][1] - m[1][0] * m[0][1];
+    double s1 = m[0][0] * m[1][2] - m[1][0] * m[0][2];
+    double s2 = m[0][0] * m[1][3] - m[1][0] * m[0][3];
+    double s3 = m[0][1] * m[1][2] - m[1][1] * m[0][2];
+    double s4 = m[0][1] * m[1][3] - m[1][1] * m[0][3];
+    double s5 = m[0][2] * m[1][3] - m[1][2] * m[0][3];
+    double c5 = m[2][2] * m[3][3] - m[3][2] * m[2][3];
+    double c4 = m[2][1] * m[3][3] - m[3][1] * m[2][3];
+    double c3 = m[2][1] * m[3][2] - m[3][1] * m[2][2];
+    double c2 = m[2][0] * m[3][3] - m[3][0] * m[2][3];
+    double c1 = m[2][0] * m[3][2] - m[3][0] * m[2][2];
+    double c0 = m[2][0] * m[3][1] - m[3][0] * m[2][1];
+    double det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    double k = 1.0 / det, b[4][4] = {
+        {m[1][1] * c5 - m[1][2] * c4 + m[1][3] * c3,
+         -m[0][1] * c5 + m[0][2] * c4 - m[0][3] * c3,
+         m[3][1] * s5 - m[3][2] * s4 + m[3][3] * s3,
+         -m[2][1] * s5 + m[2][2] * s4 - m[2][3] * s3},
+        {-m[1][0] * c5 + m[1][2] * c2 - m[1][3] * c1,
+         m[0][0] * c5 - m[0][2] * c2 + m[0][3] * c1,
+         -m[3][0] * s5 + m[3][2] * s2 - m[3][3] * s1,
+         m[2][0] * s5 - m[2][2] * s2 + m[2][3] * s1},
+        {m[1][0] * c4 - m[1][1] * c2 + m[1][3] * c0,
+         -m[0][0] * c4 + m[0][1] * c2 - m[0][3] * c0,
+         m[3][0] * s4 - m[3][1] * s2 + m[3][3] * s0,
+         -m[2][0] * s4 + m[2][1] * s2 - m[2][3] * s0},
+        {-m[1][0] * c3 + m[1][1] * c1 - m[1][2] * c0,
+         m[0][0] * c3 - m[0][1] * c1 + m[0][2] * c0,
+         -m[3][0] * s3 + m[3][1] * s1 - m[3][2] * s0,
+         m[2][0] * s3 - m[2][1] * s1 + m[2][2] * s0}};
+    r->det[l] = det;
+    for (int i = 0; i < 4 && inv; i++)
+      for (int j = 0; j < 4; j++) S21_LANE(inv, 4, i, j)[l] = b[i][j] * k;
+  }
+}
+
+/*
+ * Gauss-Jordan with partial pivoting on w-column rows of a, each lane
+ * picking its own pivot. Only the row swaps run lane by lane; the
+ * elimination itself updates all lanes at once. With w == n only the
+ * trailing rows are eliminated, which is all a determinant needs; w == 2n
+ * reduces [A | I] to [I | A^-1].
+ */
+static inline __attribute__((always_inline)) void s21_lanes_eliminate(
+    int n, int w, double *a, s21_lanes_t *r) {
+  int jordan = w > n;
+  for (int l = 0; l < S21_BATCH_LANES; l++) {
+    r->det[l] = 1.0;
+    r->singular[l] = FALSE;
+  }
+  for (int c = 0; c < n; c++) {
+    int piv[S21_BATCH_LANES];
+    double best[S21_BATCH_LANES], rcp[S21_BATCH_LANES];
+    for (int l = 0; l < S21_BATCH_LANES; l++) {
+      piv[l] = c;
+      best[l] = fabs(S21_LANE(a, w, c, c)[l]);
+    }
+    for (int i = c + 1; i < n; i++) {
+      for (int l = 0; l < S21_BATCH_LANES; l++) {
+        double v = fabs(S21_LANE(a, w, i, c)[l]);
+        piv[l] = v > best[l] ? i : piv[l];
+        best[l] = v > best[l] ? v : best[l];
+      }
+    }
+    for (int l = 0; l < S21_BATCH_LANES; l++) {
+      for (int j = c; j < w && piv[l] != c; j++) {
+        double t = S21_LANE(a, w, c, j)[l];
+        S21_LANE(a, w, c, j)[l] = S21_LANE(a, w, piv[l], j)[l];
+        S21_LANE(a, w, piv[l], j)[l] = t;
+      }
+    }
+    for (int l = 0; l < S21_BATCH_LANES; l++) {
+      double p = S21_LANE(a, w, c, c)[l];
+      int zero = fabs(p) <= r->tol[l];
+      r->det[l] *= piv[l] == c ? p : -p;
+      r->singular[l] |= zero;
+      rcp[l] = zero ? 0.0 : 1.0 / p;
+    }
+    if (jordan) {
+      for (int j = c; j < w; j++) {
+        double *x = S21_LANE(a, w, c, j);
+        for (int l = 0; l < S21_BATCH_LANES; l++) x[l] *= rcp[l];
+      }
+    }
+    for (int i = jordan ? 0 : c + 1; i < n; i++) {
+      double f[S21_BATCH_LANES];
+      if (i == c) continue;
+      for (int l = 0; l < S21_BATCH_LANES; l++)
+        f[l] = S21_LANE(a, w, i, c)[l] * (jordan ? 1.0 : rcp[l]);
+      for (int j = c; j < w; j++) {
+        double *restrict x = S21_LANE(a, w, c, j);
+        double *restrict y = S21_LANE(a, w, i, j);
+        for (int l = 0; l < S21_BATCH_LANES; l++) y[l] -= f[l] * x[l];
+      }
+    }
+  }
+}
+
+/* a holds n x n inputs; with inv, a must have room for the n x 2n rows */
+static inline __attribute__((always_inline)) void s21_lanes_square(
+    int n, double *a, double *inv, s21_lanes_t *r) {
+  s21_lanes_tol(n, a, r);
+  if (n <= 4) {
+    if (n == 1) {
+      for (int l = 0; l < S21_BATCH_LANES; l++) {
+        r->det[l] = a[l];
+        if (inv) inv[l] = 1.0 / a[l];
+      }
+    } else if (n == 2) {
+      s21_lanes_2x2(a, inv, r);
+    } else if (n == 3) {
+      s21_lanes_3x3(a, inv, r);
+    } else {
+      s21_lanes_4x4(a, inv, r);
+    }
+    s21_lanes_flag(n, r);
+  } else if (!inv) {
+    s21_lanes_eliminate(n, n, a, r);
+  } else {
+    for (int i = n - 1; i >= 0; i--) {
+      for (int j = 2 * n - 1; j >= 0; j--) {
+        double *x = S21_LANE(a, 2 * n, i, j);
+        for (int l = 0; l < S21_BATCH_LANES; l++)
+          x[l] = j < n ? S21_LANE(a, n, i, j)[l] : j - n == i;
+      }
+    }
+    s21_lanes_eliminate(n, 2 * n, a, r);
+    for (int i = 0; i < n; i++)
+      for (int j = 0; j < n; j++)
+        memcpy(S21_LANE(inv, n, i, j), S21_LANE(a, 2 * n, i, n + j),
+               sizeof(double) * S21_BATCH_LANES);
+  }
+}
+
+static void s21_lanes_square_generic(int n, double *a, double *inv,
+                                     s21_lanes_t *r) {
+  s21_lanes_square(n, a, inv, r);
+}
+
+#ifdef S21_X86
+__attribute__((target("avx2"))) static void s21_lanes_square_avx2(
+    int n, double *a, double *inv, s21_lanes_t *r) {
+  s21_lanes_square(n, a, inv, r);
+}
+
+__attribute__((target("avx512f"))) static void s21_lanes_square_avx512(
+    int n, double *a, double *inv, s21_lanes_t *r) {
+  s21_lanes_square(n, a, inv, r);
+}
+#endif
+
+/* gathers a lane group, runs the square kernel and writes det/inverse back */
+static void s21_batch_square_group(const s21_batch_t *job, int first,
+                                   double *buf) {
+  int n = job->m, lanes = job->count - first;
+  double *a = buf, *inv = job->mc ? buf + 2 * n * n * S21_BATCH_LANES : NULL;
+  s21_lanes_t r;
+  if (lanes > S21_BATCH_LANES) lanes = S21_BATCH_LANES;
+  for (int l = 0; l < S21_BATCH_LANES; l++) {
+    for (int i = 0; i < n; i++) {
+      const double *row = l < lanes ? job->ma[first + l].matrix[i] : NULL;
+      for (int j = 0; j < n; j++)
+        S21_LANE(a, n, i, j)[l] = row ? row[j] : i == j;
+    }
+  }
+#ifdef S21_X86
+  if (s21_isa_level() >= S21_ISA_AVX512)
+    s21_lanes_square_avx512(n, a, inv, &r);
+  else if (s21_isa_level() >= S21_ISA_AVX2)
+    s21_lanes_square_avx2(n, a, inv, &r);
+  else
+#endif
+    s21_lanes_square_generic(n, a, inv, &r);
+  for (int l = 0; l < lanes; l++) {
+    if (job->det) job->det[first + l] = r.singular[l] ? 0.0 : r.det[l];
+    if (job->singular) job->singular[first + l] = r.singular[l];
+    for (int i = 0; i < n && inv; i++) {
+      double *row = job->mc[first + l].matrix[i];
+      for (int j = 0; j < n; j++)
+        row[j] = r.singular[l] ? 0.0 : S21_LANE(inv, n, i, j)[l];
+    }
+  }
+}
+
+/* matrices past S21_BATCH_SQUARE_MAX go through LU one at a time */
+static void s21_batch_square_single(const s21_batch_t *job, int l) {
+  int singular = FALSE;
+  if (job->mc) {
+    singular = s21_inverse_matrix_into(&job->ma[l], &job->mc[l]) != OK;
+    for (int i = 0; i < job->m && singular; i++)
+      memset(job->mc[l].matrix[i], 0, sizeof(double) * job->m);
+  }
+  if (job->det) {
+    s21_lu_t *f = NULL;
+    double det = 0.0;
+    if (s21_lu_factor(&job->ma[l], &f) == OK) s21_lu_det(f, &det);
+    s21_lu_free(f);
+    job->det[l] = det;
+    singular = det == 0.0;
+  }
+  if (job->singular) job->singular[l] = singular;
+}
+
+static void s21_batch_square_task(void *ctx, int task) {
+  const s21_batch_t *job = ctx;
+  int n = job->m;
+  int first = task * S21_BATCH_TASK * S21_BATCH_LANES;
+  int last = first + S21_BATCH_TASK * S21_BATCH_LANES;
+  if (last > job->count) last = job->count;
+  s21_arena_mark_t mark = s21_arena_begin();
+  if (n <= S21_BATCH_SQUARE_MAX) {
+    double *buf = s21_scratch_alloc(sizeof(double) * S21_BATCH_LANES * 3 *
+                                    n * n);
+    for (int l = first; l < last && buf; l += S21_BATCH_LANES)
+      s21_batch_square_group(job, l, buf);
+    s21_scratch_free(buf);
+  } else {
+    for (int l = first; l < last; l++) s21_batch_square_single(job, l);
+  }
+  s21_arena_end(mark);
+}
+
+static int s21_batch_square(matrix_t *a, double *det, matrix_t *result,
+                            int *singular, int count) {
+  S21_STATS_BEGIN(det ? S21_STATS_DETERMINANT_BATCHED
+                      : S21_STATS_INVERSE_BATCHED);
+  int ret = count < 0 || !a ? ERROR : OK;
+  double flops = 0.0;
+  if (ret == OK && count > 0) {
+    ret = s21_batch_check(a, count);
+    if (ret == OK && !s21_is_square_matrix(&a[0])) ret = CALCULATION_ERROR;
+    if (ret == OK && result)
+      ret = s21_batch_reserve(result, a[0].rows, a[0].rows, a, NULL, count);
+    if (ret == OK) {
+      s21_batch_t job = {.ma = a,
+                         .mc = result,
+                         .m = a[0].rows,
+                         .n = a[0].rows,
+                         .k = a[0].rows,
+                         .count = count,
+                         .det = det,
+                         .singular = singular};
+      flops = (det ? 2.0 / 3.0 : 2.0) * job.n * job.n * job.n * count;
+      s21_batch_run(&job, s21_batch_square_task);
+    }
+  }
+  S21_STATS_END(flops);
+  return ret;
+}
+
+/* results are reused when they already hold the product's shape */
+int s21_mult_matrix_batched(matrix_t *a, matrix_t *b, matrix_t *result,
+                            int count) {
+  S21_STATS_BEGIN(S21_STATS_MULT_MATRIX_BATCHED);
+  int ret = OK;
+  double flops = 0.0;
+  if (!a || !b || !result || count < 0) {
+    ret = ERROR;
+  } else if (count > 0) {
+    ret = s21_batch_check(a, count);
+    if (ret == OK) ret = s21_batch_check(b, count);
+    if (ret == OK && a[0].columns != b[0].rows) ret = CALCULATION_ERROR;
+    if (ret == OK)
+      ret = s21_batch_reserve(result, a[0].rows, b[0].columns, a, b, count);
+    if (ret == OK) {
+      s21_batch_t job = {.ma = a,
+                         .mb = b,
+                         .mc = result,
+                         .m = a[0].rows,
+                         .n = b[0].columns,
+                         .k = a[0].columns,
+                         .count = count};
+      flops = 2.0 * job.m * job.n * job.k * count;
+      s21_batch_run(&job, s21_batch_task);
+    }
+  }
+  S21_STATS_END(flops);
+  return ret;
+}
+
+/* matrix l of a starts at a + l * stride_a; a zero stride broadcasts */
+int s21_mult_matrix_strided(int m, int k, int n, const double *a,
+                            int stride_a, const double *b, int stride_b,
+                            double *c, int stride_c, int count) {
+  S21_STATS_BEGIN(S21_STATS_MULT_MATRIX_BATCHED);
+  int ret = OK;
+  if (!a || !b || !c || m <= 0 || k <= 0 || n <= 0 || count < 0 ||
+      stride_a < 0 || stride_b < 0 || stride_c < m * n) {
+    ret = ERROR;
+  } else {
+    s21_batch_t job = {.a = a,
+                       .b = b,
+                       .c = c,
+                       .sa = stride_a,
+                       .sb = stride_b,
+                       .sc = stride_c,
+                       .m = m,
+                       .n = n,
+                       .k = k,
+                       .count = count};
+    s21_batch_run(&job, s21_batch_task);
+  }
+  S21_STATS_END(ret == OK ? 2.0 * m * n * k * count : 0.0);
+  return ret;
+}
+
+int s21_determinant_batched(matrix_t *a, double *det, int *singular,
+                            int count) {
+  return det ? s21_batch_square(a, det, NULL, singular, count) : ERROR;
+}
+
+int s21_inverse_batched(matrix_t *a, matrix_t *result, int *singular,
+                        int count) {
+  return result ? s21_batch_square(a, NULL, result, singular, count) : ERROR;
+}
@@ -0,0 +1,291 @@
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#include "s21_internal.h"
+
+#define S21_CHOLESKY_BLOCK 64
+/* rows per trailing update product, trading wasted upper blocks for size */
+#define S21_CHOLESKY_UPDATE 256
+/* smaller matrices gain little and keep the exact LU results */
+#define S21_SPD_MIN 32
+
+static int s21_spd_enabled = TRUE;
+
+static int s21_min(int a, int b) { return a < b ? a : b; }
+
+static double s21_lower_max_abs(matrix_t *a) {
+  double max = 0.0;
+  for (int i = 0; i < a->rows; i++) {
+    for (int j = 0; j <= i; j++) {
+      double t = fabs(a->matrix[i][j]);
+      if (t > max) max = t;
+    }
+  }
+  return max;
+}
+
+/*
+ * Factorisation of columns k0..k1, earlier columns already applied to
+ * them: the diagonal block unblocked, then each row below it solved against
+ * the block in axpy form through d, which receives the block transposed.
+ * FALSE at a pivot not above tol.
+ */
+static int s21_cholesky_panel(matrix_t *l, int k0, int k1, double tol,
+                              matrix_t *d) {
+  int ret = TRUE, n = l->rows, b = k1 - k0;
+  for (int j = k0; j < k1 && ret; j++) {
+    double *rj = l->matrix[j];
+    double s = rj[j];
+    for (int p = k0; p < j; p++) s -= rj[p] * rj[p];
+    if (!(s > tol)) {
+      ret = FALSE;
+    } else {
+      rj[j] = sqrt(s);
+      for (int i = j + 1; i < k1; i++) {
+        double *ri = l->matrix[i];
+        s = ri[j];
+        for (int p = k0; p < j; p++) s -= ri[p] * rj[p];
+        ri[j] = s / rj[j];
+        d->matrix[j - k0][i - k0] = ri[j];
+      }
+      d->matrix[j - k0][j - k0] = 1.0 / rj[j];
+    }
+  }
+  for (int i = k1; i < n && ret; i++) {
+    double *ri = l->matrix[i] + k0;
+    for (int j = 0; j < b; j++) {
+      ri[j] *= d->matrix[j][j];
+      s21_kernels->axpy(d->matrix[j] + j + 1, -ri[j], ri + j + 1, b - j - 1);
+    }
+  }
+  return ret;
+}
+
+/*
+ * Blocked right-looking Cholesky of the lower triangle of l, in place. The
+ * trailing update A22 -= L21 L21^T goes through s21_gemm one block row at a
+ * time, stopping at the diagonal, so only the lower half is computed.
+ */
+static int s21_cholesky_decompose(matrix_t *l) {
+  int n = l->rows;
+  double tol = n * DBL_EPSILON * s21_lower_max_abs(l);
+  double *a_rows[S21_CHOLESKY_UPDATE], *c_rows[S21_CHOLESKY_UPDATE];
+  double **panel = s21_scratch_alloc(sizeof(double *) * n);
+  matrix_t t = {0}, d = {0};
+  int ret = panel ? s21_scratch_matrix(S21_CHOLESKY_BLOCK, n, &t) : ERROR;
+  if (ret == OK)
+    ret = s21_scratch_matrix(S21_CHOLESKY_BLOCK, S21_CHOLESKY_BLOCK, &d);
+  for (int k0 = 0; k0 < n && ret == OK; k0 += S21_CHOLESKY_BLOCK) {
+    int k1 = s21_min(k0 + S21_CHOLESKY_BLOCK, n);
+    if (!s21_cholesky_panel(l, k0, k1, tol, &d)) ret = CALCULATION_ERROR;
+    if (ret == OK && k1 < n) {
+      for (int i = k1; i < n; i++) panel[i - k1] = l->matrix[i] + k0;
+      s21_transpose_rows(panel, n - k1, k1 - k0, t.matrix);
+      for (int i0 = k1; i0 < n; i0 += S21_CHOLESKY_UPDATE) {
+        int i1 = s21_min(i0 + S21_CHOLESKY_UPDATE, n);
+        for (int i = i0; i < i1; i++) {
+          a_rows[i - i0] = l->matrix[i] + k0;
+          c_rows[i - i0] = l->matrix[i] + k1;
+        }
+        s21_gemm(i1 - i0, i1 - k1, k1 - k0, -1.0, a_rows, t.matrix, c_rows);
+      }
+    }
+  }
+  s21_remove_matrix(&d);
+  s21_remove_matrix(&t);
+  s21_scratch_free(panel);
+  return ret;
+}
+
+/* w = inverse of the lower triangular l, itself lower triangular */
+static void s21_invert_lower(matrix_t *l, matrix_t *w, double **b_rows) {
+  int n = l->rows;
+  double *a_rows[S21_CHOLESKY_BLOCK], *c_rows[S21_CHOLESKY_BLOCK];
+  for (int i0 = 0; i0 < n; i0 += S21_CHOLESKY_BLOCK) {
+    int i1 = s21_min(i0 + S21_CHOLESKY_BLOCK, n);
+    for (int j0 = 0; j0 < i0; j0 += S21_CHOLESKY_BLOCK) {
+      for (int i = i0; i < i1; i++) {
+        a_rows[i - i0] = l->matrix[i] + j0;
+        c_rows[i - i0] = w->matrix[i] + j0;
+      }
+      for (int k = j0; k < i0; k++) b_rows[k - j0] = w->matrix[k] + j0;
+      s21_gemm(i1 - i0, S21_CHOLESKY_BLOCK, i0 - j0, -1.0, a_rows, b_rows,
+               c_rows);
+    }
+    for (int i = i0; i < i1; i++) {
+      double *wi = w->matrix[i];
+      for (int k = i0; k < i; k++)
+        s21_kernels->axpy(w->matrix[k], -l->matrix[i][k], wi, k + 1);
+      wi[i] += 1.0;
+      s21_kernels->scale(wi, 1.0 / l->matrix[i][i], wi, i + 1);
+    }
+  }
+}
+
+/* r = w^T w for lower triangular w: lower blocks only, then mirrored */
+static void s21_lower_gram(matrix_t *w, matrix_t *wt, matrix_t *r,
+                           double **b_rows) {
+  int n = w->rows;
+  double *a_rows[S21_CHOLESKY_BLOCK], *c_rows[S21_CHOLESKY_BLOCK];
+  s21_transpose_rows(w->matrix, n, n, wt->matrix);
+  for (int i = 0; i < n; i++) memset(r->matrix[i], 0, sizeof(double) * n);
+  for (int i0 = 0; i0 < n; i0 += S21_CHOLESKY_BLOCK) {
+    int i1 = s21_min(i0 + S21_CHOLESKY_BLOCK, n);
+    for (int j0 = 0; j0 <= i0; j0 += S21_CHOLESKY_BLOCK) {
+      int j1 = s21_min(j0 + S21_CHOLESKY_BLOCK, n);
+      for (int i = i0; i < i1; i++) {
+        a_rows[i - i0] = wt->matrix[i] + i0;
+        c_rows[i - i0] = r->matrix[i] + j0;
+      }
+      for (int k = i0; k < n; k++) b_rows[k - i0] = w->matrix[k] + j0;
+      s21_gemm(i1 - i0, j1 - j0, n - i0, 1.0, a_rows, b_rows, c_rows);
+    }
+  }
+  for (int i = 0; i < n; i++) {
+    for (int j = i + 1; j < n; j++) r->matrix[i][j] = r->matrix[j][i];
+  }
+}
+
+void s21_cholesky_substitute(matrix_t *l, matrix_t *lt, matrix_t *x) {
+  int n = l->rows, m = x->columns;
+  double *rows[S21_CHOLESKY_BLOCK];
+  for (int i0 = 0; i0 < n; i0 += S21_CHOLESKY_BLOCK) {
+    int i1 = s21_min(i0 + S21_CHOLESKY_BLOCK, n);
+    if (i0 > 0) {
+      for (int i = i0; i < i1; i++) rows[i - i0] = l->matrix[i];
+      s21_gemm(i1 - i0, m, i0, -1.0, rows, x->matrix, x->matrix + i0);
+    }
+    for (int i = i0; i < i1; i++) {
+      double *xi = x->matrix[i];
+      for (int k = i0; k < i; k++)
+        s21_kernels->axpy(x->matrix[k], -l->matrix[i][k], xi, m);
+      s21_kernels->scale(xi, 1.0 / l->matrix[i][i], xi, m);
+    }
+  }
+  for (int i1 = n; i1 > 0; i1 -= S21_CHOLESKY_BLOCK) {
+    int i0 = i1 - S21_CHOLESKY_BLOCK > 0 ? i1 - S21_CHOLESKY_BLOCK : 0;
+    if (i1 < n) {
+      for (int i = i0; i < i1; i++) rows[i - i0] = lt->matrix[i] + i1;
+      s21_gemm(i1 - i0, m, n - i1, -1.0, rows, x->matrix + i1,
+               x->matrix + i0);
+    }
+    for (int i = i1 - 1; i >= i0; i--) {
+      double *xi = x->matrix[i];
+      for (int k = i + 1; k < i1; k++)
+        s21_kernels->axpy(x->matrix[k], -lt->matrix[i][k], xi, m);
+      s21_kernels->scale(xi, 1.0 / lt->matrix[i][i], xi, m);
+    }
+  }
+}
+
+/* exactly symmetric, as the factorisation reads only the lower triangle */
+static int s21_spd_candidate(matrix_t *a) {
+  int ret = s21_spd_enabled && s21_is_valid_matrix_t(a) &&
+            s21_is_square_matrix(a) && a->rows >= S21_SPD_MIN;
+  for (int i = 1; i < a->rows && ret; i++) {
+    for (int j = 0; j < i && ret; j++)
+      ret = a->matrix[i][j] == a->matrix[j][i];
+  }
+  return ret;
+}
+
+int s21_spd_factor(matrix_t *a, matrix_t *l) {
+  int ret = s21_spd_candidate(a) ? OK : CALCULATION_ERROR;
+  if (ret == OK) {
+    *l = s21_scratch_copy(a);
+    ret = l->matrix ? s21_cholesky_decompose(l) : ERROR;
+  }
+  return ret;
+}
+
+int s21_spd_determinant(matrix_t *a, double *result) {
+  matrix_t l = {0};
+  int ret = s21_spd_factor(a, &l);
+  if (ret == OK) {
+    double det = 1.0;
+    for (int i = 0; i < l.rows; i++) det *= l.matrix[i][i];
+    *result = det * det;
+  }
+  s21_remove_matrix(&l);
+  return ret;
+}
+
+int s21_spd_inverse(matrix_t *a, matrix_t *result, int reuse) {
+  matrix_t l = {0}, w = {0}, wt = {0};
+  int ret = s21_spd_factor(a, &l), n = l.rows;
+  double **b_rows = ret == OK ? s21_scratch_alloc(sizeof(double *) * n) : NULL;
+  if (ret == OK && !b_rows) ret = ERROR;
+  if (ret == OK) ret = s21_scratch_matrix(n, n, &w);
+  if (ret == OK) ret = s21_scratch_matrix(n, n, &wt);
+  if (ret == OK)
+    ret = reuse ? s21_reserve_matrix(n, n, result)
+                : s21_create_matrix(n, n, result);
+  if (ret == OK) {
+    s21_invert_lower(&l, &w, b_rows);
+    s21_lower_gram(&w, &wt, result, b_rows);
+  }
+  s21_scratch_free(b_rows);
+  s21_remove_matrix(&wt);
+  s21_remove_matrix(&w);
+  s21_remove_matrix(&l);
+  return ret;
+}
+
+int s21_cholesky(matrix_t *a, matrix_t *result) {
+  S21_STATS_BEGIN(S21_STATS_CHOLESKY);
+  s21_arena_mark_t mark = s21_arena_begin();
+  int ret = result && s21_is_valid_matrix_t(a) ? OK : ERROR;
+  if (ret == OK && !s21_is_square_matrix(a)) ret = CALCULATION_ERROR;
+  matrix_t l = {0};
+  if (ret == OK) {
+    l = s21_copy_matrix(a);
+    ret = l.matrix ? s21_cholesky_decompose(&l) : ERROR;
+  }
+  if (ret == OK) {
+    for (int i = 0; i < l.rows; i++)
+      memset(l.matrix[i] + i + 1, 0, sizeof(double) * (l.rows - i - 1));
+    *result = l;
+  } else {
+    s21_remove_matrix(&l);
+  }
+  s21_arena_end(mark);
+  S21_STATS_END(ret == OK ? (double)a->rows * a->rows * a->rows / 3.0 : 0.0);
+  return ret;
+}
+
+int s21_cholesky_solve(matrix_t *l, matrix_t *b, matrix_t *result) {
+  S21_STATS_BEGIN(S21_STATS_SOLVE);
+  s21_arena_mark_t mark = s21_arena_begin();
+  int ret = result && s21_is_valid_matrix_t(l) && s21_is_valid_matrix_t(b)
+                ? OK
+                : ERROR;
+  if (ret == OK && (!s21_is_square_matrix(l) || b->rows != l->rows))
+    ret = CALCULATION_ERROR;
+  for (int i = 0; ret == OK && i < l->rows; i++) {
+    if (!(fabs(l->matrix[i][i]) > 0.0)) ret = CALCULATION_ERROR;
+  }
+  matrix_t lt = {0};
+  if (ret == OK) ret = s21_scratch_matrix(l->rows, l->rows, &lt);
+  if (ret == OK) ret = s21_create_matrix(b->rows, b->columns, result);
+  if (ret == OK) {
+    s21_transpose_rows(l->matrix, l->rows, l->rows, lt.matrix);
+    for (int i = 0; i < b->rows; i++)
+      memcpy(result->matrix[i], b->matrix[i], sizeof(double) * b->columns);
+    s21_cholesky_substitute(l, &lt, result);
+  }
+  s21_remove_matrix(&lt);
+  s21_arena_end(mark);
+  S21_STATS_END(ret == OK ? 2.0 * b->rows * b->rows * b->columns : 0.0);
+  return ret;
+}
+
+void s21_set_spd_detection(int enabled) { s21_spd_enabled = enabled != 0; }
+
+int s21_spd_detection(void) { return s21_spd_enabled; }
+
+/* S21_MATRIX_SPD=0 leaves every square matrix to LU */
+__attribute__((constructor)) static void s21_cholesky_init(void) {
+  const char *env = getenv("S21_MATRIX_SPD");
+  if (env) s21_set_spd_detection((int)strtol(env, NULL, 10));
+}
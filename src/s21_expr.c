@@ -0,0 +1,135 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "s21_internal.h"
+
+#define S21_EXPR_CHUNK 512
+#define S21_EXPR_STRIPE 64
+#define S21_EXPR_PARALLEL (1024 * 1024)
+
+typedef struct {
+  matrix_t *m;
+  double k;
+} s21_term_t;
+
+/* any chain of sums, differences and scalings is a sum of k * m terms */
+struct s21_expr {
+  s21_term_t *terms;
+  int count;
+  int rows, columns;
+  int status;
+};
+
+typedef struct {
+  const s21_expr_t *e;
+  matrix_t *result;
+} s21_expr_job_t;
+
+s21_expr_t *s21_expr_matrix(matrix_t *a) {
+  s21_expr_t *e = calloc(1, sizeof(s21_expr_t));
+  if (e) {
+    e->terms = malloc(sizeof(s21_term_t));
+    if (!e->terms) {
+      free(e);
+      e = NULL;
+    } else {
+      e->terms[0].m = a;
+      e->terms[0].k = 1.0;
+      e->count = 1;
+      e->status = s21_is_valid_matrix_t(a) ? OK : ERROR;
+      if (e->status == OK) {
+        e->rows = a->rows;
+        e->columns = a->columns;
+      }
+    }
+  }
+  return e;
+}
+
+void s21_expr_free(s21_expr_t *e) {
+  if (e) free(e->terms);
+  free(e);
+}
+
+/* a term over storage already in the chain only changes its factor */
+static void s21_expr_append(s21_expr_t *e, s21_term_t t) {
+  int i = 0;
+  while (i < e->count && e->terms[i].m->matrix != t.m->matrix) i++;
+  if (i < e->count) {
+    e->terms[i].k += t.k;
+  } else {
+    e->terms[e->count++] = t;
+  }
+}
+
+/* the same chain on both sides is simply doubled */
+s21_expr_t *s21_expr_add(s21_expr_t *a, s21_expr_t *b) {
+  s21_term_t *terms = NULL;
+  if (a && b && a != b)
+    terms = realloc(a->terms, sizeof(s21_term_t) * (a->count + b->count));
+  if (a && a == b) {
+    s21_expr_scale(a, 2.0);
+  } else if (!terms) {
+    s21_expr_free(a);
+    s21_expr_free(b);
+    a = NULL;
+  } else {
+    a->terms = terms;
+    if (a->status == OK && b->status != OK) {
+      a->status = b->status;
+    } else if (a->status == OK &&
+               (a->rows != b->rows || a->columns != b->columns)) {
+      a->status = CALCULATION_ERROR;
+    }
+    for (int i = 0; i < b->count && a->status == OK; i++)
+      s21_expr_append(a, b->terms[i]);
+    s21_expr_free(b);
+  }
+  return a;
+}
+
+s21_expr_t *s21_expr_scale(s21_expr_t *a, double k) {
+  for (int i = 0; a && i < a->count; i++) a->terms[i].k *= k;
+  return a;
+}
+
+s21_expr_t *s21_expr_sub(s21_expr_t *a, s21_expr_t *b) {
+  return a == b ? s21_expr_scale(a, 0.0)
+                : s21_expr_add(a, s21_expr_scale(b, -1.0));
+}
+
+/* each chunk is combined in a cached tile, so result may alias a term */
+static void s21_expr_row(const s21_expr_t *e, int i, double *out) {
+  double tile[S21_EXPR_CHUNK] __attribute__((aligned(S21_ALIGN)));
+  for (int j = 0; j < e->columns; j += S21_EXPR_CHUNK) {
+    int n = e->columns - j;
+    if (n > S21_EXPR_CHUNK) n = S21_EXPR_CHUNK;
+    s21_kernels->scale(e->terms[0].m->matrix[i] + j, e->terms[0].k, tile, n);
+    for (int t = 1; t < e->count; t++)
+      s21_kernels->axpy(e->terms[t].m->matrix[i] + j, e->terms[t].k, tile, n);
+    memcpy(out + j, tile, sizeof(double) * n);
+  }
+}
+
+static void s21_expr_stripe(void *ctx, int task) {
+  s21_expr_job_t *job = ctx;
+  int first = task * S21_EXPR_STRIPE, last = first + S21_EXPR_STRIPE;
+  if (last > job->e->rows) last = job->e->rows;
+  for (int i = first; i < last; i++)
+    s21_expr_row(job->e, i, job->result->matrix[i]);
+}
+
+int s21_expr_eval(s21_expr_t *e, matrix_t *result) {
+  S21_STATS_BEGIN(S21_STATS_EXPR_EVAL);
+  int ret = e && result ? e->status : ERROR;
+  if (ret == OK) ret = s21_reserve_matrix(e->rows, e->columns, result);
+  if (ret == OK && (double)e->rows * e->columns < S21_EXPR_PARALLEL) {
+    for (int i = 0; i < e->rows; i++) s21_expr_row(e, i, result->matrix[i]);
+  } else if (ret == OK) {
+    s21_expr_job_t job = {e, result};
+    int stripes = (e->rows + S21_EXPR_STRIPE - 1) / S21_EXPR_STRIPE;
+    s21_parallel_for(stripes, s21_expr_stripe, &job);
+  }
+  S21_STATS_END(ret == OK ? (2.0 * e->count - 1) * e->rows * e->columns : 0.0);
+  return ret;
+}
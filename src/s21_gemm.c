@@ -0,0 +1,201 @@
+#include <string.h>
+
+#include "s21_internal.h"
+
+#define S21_GEMM_MR 4
+#define S21_GEMM_NR 8
+#define S21_GEMM_MC 96
+#define S21_GEMM_KC 256
+#define S21_GEMM_NC 2048
+#define S21_GEMM_SMALL (48 * 48 * 48)
+#define S21_GEMM_PARALLEL (128 * 128 * 128)
+#define S21_GEMM_TILE_M (2 * S21_GEMM_MC)
+#define S21_GEMM_TILE_N 512
+
+typedef struct {
+  int m, n, k;
+  double alpha;
+  double *const *a;
+  double *const *b;
+  double **c;
+  int tile_m, tile_n, tiles_n;
+} s21_gemm_job_t;
+
+static inline __attribute__((always_inline)) void s21_gemm_small(
+    int m, int n, int k, double alpha, double *const *a, double *const *b,
+    int col, double **c) {
+  for (int i = 0; i < m; i++) {
+    double *ci = c[i] + col;
+    for (int r = 0; r < k; r++) {
+      double air = alpha * a[i][r];
+      const double *br = b[r] + col;
+      for (int j = 0; j < n; j++) {
+        ci[j] += air * br[j];
+      }
+    }
+  }
+}
+
+/* A block is stored as MR-row slivers, column after column, zero padded */
+static void s21_pack_a(int mc, int kc, double *const *a, int row, int col,
+                       double *buf) {
+  for (int ir = 0; ir < mc; ir += S21_GEMM_MR) {
+    int mr = mc - ir < S21_GEMM_MR ? mc - ir : S21_GEMM_MR;
+    for (int p = 0; p < kc; p++) {
+      for (int i = 0; i < S21_GEMM_MR; i++) {
+        *buf++ = i < mr ? a[row + ir + i][col + p] : 0.0;
+      }
+    }
+  }
+}
+
+/* B panel is stored as NR-column slivers, row after row, zero padded */
+static void s21_pack_b(int kc, int nc, double *const *b, int row, int col,
+                       double *buf) {
+  for (int jr = 0; jr < nc; jr += S21_GEMM_NR) {
+    int nr = nc - jr < S21_GEMM_NR ? nc - jr : S21_GEMM_NR;
+    for (int p = 0; p < kc; p++) {
+      const double *src = b[row + p] + col + jr;
+      int j = 0;
+      for (; j < nr; j++) *buf++ = src[j];
+      for (; j < S21_GEMM_NR; j++) *buf++ = 0.0;
+    }
+  }
+}
+
+static inline __attribute__((always_inline)) void s21_gemm_kernel(
+    int kc, const double *a, const double *b,
+    double ab[S21_GEMM_MR][S21_GEMM_NR]) {
+  double acc[S21_GEMM_MR][S21_GEMM_NR] = {{0}};
+  for (int p = 0; p < kc; p++) {
+    for (int i = 0; i < S21_GEMM_MR; i++) {
+      double ai = a[i];
+      for (int j = 0; j < S21_GEMM_NR; j++) {
+        acc[i][j] += ai * b[j];
+      }
+    }
+    a += S21_GEMM_MR;
+    b += S21_GEMM_NR;
+  }
+  memcpy(ab, acc, sizeof(acc));
+}
+
+static inline __attribute__((always_inline)) void s21_gemm_macro(
+    int mc, int nc, int kc, double alpha, const double *ap, const double *bp,
+    double **c, int row, int col) {
+  double ab[S21_GEMM_MR][S21_GEMM_NR];
+  for (int jr = 0; jr < nc; jr += S21_GEMM_NR) {
+    int nr = nc - jr < S21_GEMM_NR ? nc - jr : S21_GEMM_NR;
+    for (int ir = 0; ir < mc; ir += S21_GEMM_MR) {
+      int mr = mc - ir < S21_GEMM_MR ? mc - ir : S21_GEMM_MR;
+      s21_gemm_kernel(kc, ap + ir * kc, bp + jr * kc, ab);
+      for (int i = 0; i < mr; i++) {
+        double *ci = c[row + ir + i] + col + jr;
+        for (int j = 0; j < nr; j++) ci[j] += alpha * ab[i][j];
+      }
+    }
+  }
+}
+
+/*
+ * c[0..m)[col..col+n) += alpha * a * b[0..k)[col..col+n). The body is
+ * compiled once per ISA level, the kernels above being inlined into each.
+ */
+static inline __attribute__((always_inline)) void s21_gemm_serial_body(
+    int m, int n, int k, double alpha, double *const *a, double *const *b,
+    int col, double **c) {
+  s21_arena_mark_t mark = s21_arena_begin();
+  double *ap = NULL, *bp = NULL;
+  if ((double)m * n * k > S21_GEMM_SMALL) {
+    ap = s21_scratch_alloc(sizeof(double) * S21_GEMM_MC * S21_GEMM_KC);
+    bp = s21_scratch_alloc(sizeof(double) * S21_GEMM_KC * S21_GEMM_NC);
+  }
+  if (!ap || !bp) {
+    s21_gemm_small(m, n, k, alpha, a, b, col, c);
+  } else {
+    for (int jc = 0; jc < n; jc += S21_GEMM_NC) {
+      int nc = n - jc < S21_GEMM_NC ? n - jc : S21_GEMM_NC;
+      for (int pc = 0; pc < k; pc += S21_GEMM_KC) {
+        int kc = k - pc < S21_GEMM_KC ? k - pc : S21_GEMM_KC;
+        s21_pack_b(kc, nc, b, pc, col + jc, bp);
+        for (int ic = 0; ic < m; ic += S21_GEMM_MC) {
+          int mc = m - ic < S21_GEMM_MC ? m - ic : S21_GEMM_MC;
+          s21_pack_a(mc, kc, a, ic, pc, ap);
+          s21_gemm_macro(mc, nc, kc, alpha, ap, bp, c, ic, col + jc);
+        }
+      }
+    }
+  }
+  s21_scratch_free(ap);
+  s21_scratch_free(bp);
+  s21_arena_end(mark);
+}
+
+static void s21_gemm_serial_generic(int m, int n, int k, double alpha,
+                                    double *const *a, double *const *b,
+                                    int col, double **c) {
+  s21_gemm_serial_body(m, n, k, alpha, a, b, col, c);
+}
+
+#ifdef S21_MULTIVERSION
+__attribute__((target("avx2"))) static void s21_gemm_serial_avx2(
+    int m, int n, int k, double alpha, double *const *a, double *const *b,
+    int col, double **c) {
+  s21_gemm_serial_body(m, n, k, alpha, a, b, col, c);
+}
+
+__attribute__((target("avx512f"))) static void s21_gemm_serial_avx512(
+    int m, int n, int k, double alpha, double *const *a, double *const *b,
+    int col, double **c) {
+  s21_gemm_serial_body(m, n, k, alpha, a, b, col, c);
+}
+#endif
+
+/* one branch per block product keeps s21_set_isa_level in charge */
+static void s21_gemm_serial(int m, int n, int k, double alpha,
+                            double *const *a, double *const *b, int col,
+                            double **c) {
+#ifdef S21_MULTIVERSION
+  if (s21_kernels->level == S21_ISA_AVX512)
+    s21_gemm_serial_avx512(m, n, k, alpha, a, b, col, c);
+  else if (s21_kernels->level == S21_ISA_AVX2)
+    s21_gemm_serial_avx2(m, n, k, alpha, a, b, col, c);
+  else
+#endif
+    s21_gemm_serial_generic(m, n, k, alpha, a, b, col, c);
+}
+
+static void s21_gemm_tile(void *ctx, int task) {
+  s21_gemm_job_t *job = ctx;
+  int i0 = task / job->tiles_n * job->tile_m;
+  int j0 = task % job->tiles_n * job->tile_n;
+  int mt = job->m - i0 < job->tile_m ? job->m - i0 : job->tile_m;
+  int nt = job->n - j0 < job->tile_n ? job->n - j0 : job->tile_n;
+  s21_gemm_serial(mt, nt, job->k, job->alpha, job->a + i0, job->b, j0,
+                  job->c + i0);
+}
+
+/* large products are cut into C tiles, shrunk until every thread has work */
+void s21_gemm(int m, int n, int k, double alpha, double *const *a,
+              double *const *b, double **c) {
+  int threads = s21_get_num_threads();
+  if (threads == 1 || (double)m * n * k < S21_GEMM_PARALLEL) {
+    s21_gemm_serial(m, n, k, alpha, a, b, 0, c);
+  } else {
+    s21_gemm_job_t job = {m, n, k, alpha, a, b, c, S21_GEMM_TILE_M,
+                          S21_GEMM_TILE_N, 0};
+    int tiles = 0;
+    while (1) {
+      job.tiles_n = (n + job.tile_n - 1) / job.tile_n;
+      tiles = (m + job.tile_m - 1) / job.tile_m * job.tiles_n;
+      if (tiles >= 4 * threads) break;
+      if (job.tile_n > 8 * S21_GEMM_NR)
+        job.tile_n /= 2;
+      else if (job.tile_m > 8 * S21_GEMM_MR)
+        job.tile_m /= 2;
+      else
+        break;
+    }
+    s21_parallel_for(tiles, s21_gemm_tile, &job);
+  }
+}
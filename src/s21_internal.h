@@ -0,0 +1,139 @@
+#ifndef S21_INTERNAL_H
+#define S21_INTERNAL_H
+
+#include <stdatomic.h>
+
+#include "s21_matrix.h"
+
+int s21_is_valid_matrix_t(matrix_t *);
+int s21_is_square_matrix(matrix_t *);
+int s21_equal_double(double, double);
+int s21_equal_dims(matrix_t *, matrix_t *);
+size_t s21_row_table_bytes(int);
+double *s21_matrix_data(double **, int);
+size_t s21_block_bytes(int, int);
+int s21_reserve_matrix(int, int, matrix_t *);
+void s21_layout_rows(double **, int, int);
+
+/*
+ * Temporaries of internal algorithms: taken from the thread arena unless
+ * S21_MATRIX_ARENA=0, released together by the enclosing s21_arena_end.
+ * s21_scratch_free and s21_remove_matrix only free heap blocks.
+ */
+int s21_arena_owns(const void *);
+void *s21_scratch_alloc(size_t);
+void s21_scratch_free(void *);
+int s21_scratch_matrix(int, int, matrix_t *);
+matrix_t s21_scratch_copy(matrix_t *);
+matrix_t s21_copy_matrix(matrix_t *);
+
+/* TRUE when table came from s21_matrix_mmap, which is then unmapped */
+int s21_unmap_matrix(double **);
+/* the same test without unmapping */
+int s21_is_mapped(double **);
+
+/*
+ * A binary matrix file written in place: s21_file_create sizes a zeroed
+ * temporary next to path and returns its descriptor, elements go to
+ * s21_file_offset, and s21_file_finish adds the header and renames it over
+ * path when status is OK, discarding it otherwise.
+ */
+int s21_file_create(const char *path, int rows, int columns);
+size_t s21_file_offset(int columns, int row, int column);
+int s21_file_finish(int fd, const char *path, int rows, int columns,
+                    int status);
+
+/*
+ * Cholesky paths taken by s21_determinant and s21_inverse_matrix when SPD
+ * detection is on: CALCULATION_ERROR, with nothing written, unless a is
+ * exactly symmetric and positive definite. s21_spd_factor leaves L in the
+ * lower triangle of a scratch copy of a.
+ */
+int s21_spd_factor(matrix_t *a, matrix_t *l);
+int s21_spd_determinant(matrix_t *a, double *result);
+int s21_spd_inverse(matrix_t *a, matrix_t *result, int reuse);
+/* x = inv(L L^T) x, forward through l and backward through lt = L^T */
+void s21_cholesky_substitute(matrix_t *l, matrix_t *lt, matrix_t *x);
+
+/* element (i, j) of lane l lives at [(i * columns + j) * lanes + l] */
+#define S21_BATCH_LANES 8
+
+typedef struct {
+  int level;
+  void (*add)(const double *, const double *, double *, int);
+  void (*sub)(const double *, const double *, double *, int);
+  void (*scale)(const double *, double, double *, int);
+  /* r += a * k */
+  void (*axpy)(const double *, double, double *, int);
+  int (*eq)(const double *, const double *, int);
+  /* b[c][bj + r] = a[r][aj + c] for a 4x4 block */
+  void (*transpose4)(double *const *, int, double *const *, int);
+  /* b[c][bj..bj + m) = t[c][0..m) for c < n, bypassing the cache */
+  void (*stream)(double *const *, int, double *const *, int, int);
+  /* c = a * b for S21_BATCH_LANES interleaved m x k by k x n matrices */
+  void (*mult_soa)(int, int, int, const double *, const double *, double *);
+  /* sum of v[p] * x[index[p]] for p < n */
+  double (*gather_dot)(const double *v, const int *index, const double *x,
+                       int n);
+} s21_kernels_t;
+
+/*
+ * x86 builds compile ISA-dependent internals once per level and call the
+ * version matching s21_kernels->level, so S21_MATRIX_ISA caps them too.
+ * GNU IFUNC is not used: a resolver run under eager binding sees no
+ * environment yet, and a bound symbol cannot follow s21_set_isa_level.
+ */
+#if defined(__x86_64__) || defined(__i386__)
+#define S21_MULTIVERSION 1
+#endif
+
+/*
+ * row kernels for the ISA level chosen by s21_set_isa_level, published
+ * whole so that threads mid-product see the old table or the new one
+ */
+extern _Atomic(const s21_kernels_t *) s21_kernels;
+
+/* c += alpha * a * b for an m x k by k x n product over row tables */
+void s21_gemm(int m, int n, int k, double alpha, double *const *a,
+              double *const *b, double **c);
+
+/* b = a^T for an m x n row table a; s21_transpose_square works in place */
+void s21_transpose_rows(double *const *a, int m, int n, double *const *b);
+void s21_transpose_square(double **a, int n);
+
+/* c = a * b above the Strassen cutoff; FALSE leaves the product to s21_gemm */
+int s21_strassen(int m, int n, int k, double *const *a, double *const *b,
+                 double **c);
+
+/* runs fn(ctx, 0..count) on the thread pool, the caller taking part */
+void s21_parallel_for(int count, void (*fn)(void *, int), void *ctx);
+
+/*
+ * S21_STATS_BEGIN opens the counting scope of a public function and
+ * S21_STATS_END(flops) closes it before the single return. Without
+ * S21_STATS all of them compile to nothing; flops is not evaluated.
+ */
+#ifdef S21_STATS
+typedef struct {
+  int fn;
+  int outer;
+  unsigned long long start;
+} s21_stats_scope_t;
+
+s21_stats_scope_t s21_stats_begin(int);
+void s21_stats_end(s21_stats_scope_t, double);
+void s21_stats_alloc(size_t, int);
+
+#define S21_STATS_BEGIN(fn) \
+  s21_stats_scope_t s21_stats_scope = s21_stats_begin(fn)
+#define S21_STATS_END(flops) s21_stats_end(s21_stats_scope, (flops))
+#define S21_STATS_ALLOC(bytes) s21_stats_alloc((bytes), 0)
+#define S21_STATS_TEMPORARY() s21_stats_alloc(0, 1)
+#else
+#define S21_STATS_BEGIN(fn) ((void)0)
+#define S21_STATS_END(flops) ((void)sizeof(flops))
+#define S21_STATS_ALLOC(bytes) ((void)0)
+#define S21_STATS_TEMPORARY() ((void)0)
+#endif
+
+#endif
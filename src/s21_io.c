@@ -0,0 +1,310 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "s21_internal.h"
+
+#define S21_FILE_MAGIC "S21MTRX"
+#define S21_FILE_VERSION 1
+#define S21_DTYPE_F64 1
+/* rows of ld doubles, zero padded past columns, as s21_create_matrix */
+#define S21_LAYOUT_ROW_PADDED 1
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t dtype;
+  uint32_t layout;
+  int32_t rows;
+  int32_t columns;
+  int32_t ld;
+  uint64_t data_offset;
+  uint64_t data_checksum;
+  /* over every byte before it */
+  uint64_t header_checksum;
+  uint64_t reserved;
+} s21_file_header_t;
+
+_Static_assert(sizeof(s21_file_header_t) == S21_ALIGN,
+               "the data starts on the cache line after the header");
+
+typedef struct s21_mapping {
+  double **table;
+  void *base;
+  size_t length;
+  struct s21_mapping *next;
+} s21_mapping_t;
+
+static pthread_mutex_t s21_mappings_lock = PTHREAD_MUTEX_INITIALIZER;
+static s21_mapping_t *s21_mappings;
+/* lets s21_remove_matrix skip the lock while nothing is mapped */
+static atomic_int s21_mappings_live;
+
+/* FNV-1a over 64-bit words in four independent lanes, folded at the end */
+typedef struct {
+  uint64_t lane[4];
+} s21_checksum_t;
+
+static void s21_checksum_init(s21_checksum_t *c) {
+  for (int l = 0; l < 4; l++) c->lane[l] = 0xcbf29ce484222325ull + l;
+}
+
+/* word i goes to lane i % 4, so a stream is fed in multiples of 4 words */
+static void s21_checksum_update(s21_checksum_t *c, const void *data,
+                                size_t words) {
+  const unsigned char *p = data;
+  for (size_t i = 0; i < words; i++) {
+    uint64_t w;
+    memcpy(&w, p + i * sizeof(uint64_t), sizeof(w));
+    c->lane[i % 4] = (c->lane[i % 4] ^ w) * 0x100000001b3ull;
+  }
+}
+
+static uint64_t s21_checksum_final(const s21_checksum_t *c) {
+  uint64_t h = 0xcbf29ce484222325ull;
+  for (int l = 0; l < 4; l++) h = (h ^ c->lane[l]) * 0x100000001b3ull;
+  return h;
+}
+
+static uint64_t s21_header_checksum(const s21_file_header_t *h) {
+  s21_checksum_t c;
+  s21_checksum_init(&c);
+  s21_checksum_update(&c, h, offsetof(s21_file_header_t, header_checksum) /
+                                 sizeof(uint64_t));
+  return s21_checksum_final(&c);
+}
+
+/* ERROR unless the header describes a data block within size bytes */
+static int s21_check_header(const s21_file_header_t *h, size_t size) {
+  int ret = OK;
+  if (size < sizeof(*h) || memcmp(h->magic, S21_FILE_MAGIC, 8) ||
+      h->version != S21_FILE_VERSION || h->dtype != S21_DTYPE_F64 ||
+      h->layout != S21_LAYOUT_ROW_PADDED ||
+      h->header_checksum != s21_header_checksum(h)) {
+    ret = ERROR;
+  } else if (h->rows <= 0 || h->columns <= 0 || h->ld < h->columns ||
+             h->ld % 4 || h->data_offset % S21_ALIGN ||
+             h->data_offset > size ||
+             (size - h->data_offset) / sizeof(double) / h->ld <
+                 (uint64_t)h->rows) {
+    ret = ERROR;
+  }
+  return ret;
+}
+
+/* rows go out padded to ld through a zeroed buffer, hashed on the way */
+static int s21_write_matrix(FILE *f, matrix_t *a, s21_file_header_t *h) {
+  int ret = fwrite(h, sizeof(*h), 1, f) == 1 ? OK : ERROR;
+  double *row = ret == OK ? calloc(h->ld, sizeof(double)) : NULL;
+  s21_checksum_t c;
+  s21_checksum_init(&c);
+  if (!row) ret = ERROR;
+  for (int i = 0; i < a->rows && ret == OK; i++) {
+    memcpy(row, a->matrix[i], sizeof(double) * a->columns);
+    s21_checksum_update(&c, row, h->ld);
+    if (fwrite(row, sizeof(double), h->ld, f) != (size_t)h->ld) ret = ERROR;
+  }
+  free(row);
+  if (ret == OK) {
+    h->data_checksum = s21_checksum_final(&c);
+    h->header_checksum = s21_header_checksum(h);
+    if (fseek(f, 0, SEEK_SET) || fwrite(h, sizeof(*h), 1, f) != 1)
+      ret = ERROR;
+  }
+  return ret;
+}
+
+/* files are written next to path and renamed over it once complete */
+static char *s21_tmp_path(const char *path) {
+  char *ret = path ? malloc(strlen(path) + sizeof(".tmp")) : NULL;
+  if (ret) {
+    strcpy(ret, path);
+    strcat(ret, ".tmp");
+  }
+  return ret;
+}
+
+/* file rows stay cache-line padded even where memory packs narrow rows */
+static int s21_file_ld(int columns) {
+  int per_line = S21_ALIGN / sizeof(double);
+  return (columns + per_line - 1) / per_line * per_line;
+}
+
+static s21_file_header_t s21_new_header(int rows, int columns) {
+  return (s21_file_header_t){.magic = S21_FILE_MAGIC,
+                             .version = S21_FILE_VERSION,
+                             .dtype = S21_DTYPE_F64,
+                             .layout = S21_LAYOUT_ROW_PADDED,
+                             .rows = rows,
+                             .columns = columns,
+                             .ld = s21_file_ld(columns),
+                             .data_offset = sizeof(s21_file_header_t)};
+}
+
+int s21_matrix_save(matrix_t *a, const char *path) {
+  int ret = s21_is_valid_matrix_t(a) && path ? OK : ERROR;
+  char *tmp = ret == OK ? s21_tmp_path(path) : NULL;
+  FILE *f = tmp ? fopen(tmp, "wb") : NULL;
+  if (!f) {
+    ret = ERROR;
+  } else {
+    s21_file_header_t h = s21_new_header(a->rows, a->columns);
+    ret = s21_write_matrix(f, a, &h);
+    if (fclose(f)) ret = ERROR;
+    if (ret == OK && rename(tmp, path)) ret = ERROR;
+    if (ret != OK) remove(tmp);
+  }
+  free(tmp);
+  return ret;
+}
+
+/* the whole file, read-only and shared; NULL when it cannot be mapped */
+static void *s21_map_file(const char *path, size_t *length) {
+  void *ret = NULL;
+  int fd = path ? open(path, O_RDONLY) : -1;
+  struct stat st;
+  if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0) {
+    *length = st.st_size;
+    ret = mmap(NULL, *length, PROT_READ, MAP_SHARED, fd, 0);
+    if (ret == MAP_FAILED) ret = NULL;
+  }
+  if (fd >= 0) close(fd);
+  return ret;
+}
+
+int s21_matrix_mmap(const char *path, matrix_t *result) {
+  size_t length = 0;
+  void *base = result ? s21_map_file(path, &length) : NULL;
+  const s21_file_header_t *h = base;
+  int ret = base ? s21_check_header(h, length) : ERROR;
+  s21_mapping_t *m = ret == OK ? malloc(sizeof(s21_mapping_t)) : NULL;
+  double **table = m ? malloc(sizeof(double *) * h->rows) : NULL;
+  if (table) {
+    double *data = (double *)((char *)base + h->data_offset);
+    for (int i = 0; i < h->rows; i++) table[i] = data + (size_t)i * h->ld;
+    *m = (s21_mapping_t){table, base, length, NULL};
+    pthread_mutex_lock(&s21_mappings_lock);
+    m->next = s21_mappings;
+    s21_mappings = m;
+    atomic_fetch_add(&s21_mappings_live, 1);
+    pthread_mutex_unlock(&s21_mappings_lock);
+    result->matrix = table;
+    result->rows = h->rows;
+    result->columns = h->columns;
+  } else {
+    ret = ERROR;
+    free(m);
+    if (base) munmap(base, length);
+  }
+  return ret;
+}
+
+int s21_is_mapped(double **table) {
+  int ret = FALSE;
+  if (atomic_load_explicit(&s21_mappings_live, memory_order_relaxed)) {
+    pthread_mutex_lock(&s21_mappings_lock);
+    for (s21_mapping_t *m = s21_mappings; m && !ret; m = m->next)
+      ret = m->table == table;
+    pthread_mutex_unlock(&s21_mappings_lock);
+  }
+  return ret;
+}
+
+int s21_unmap_matrix(double **table) {
+  s21_mapping_t *found = NULL;
+  if (atomic_load_explicit(&s21_mappings_live, memory_order_relaxed)) {
+    pthread_mutex_lock(&s21_mappings_lock);
+    s21_mapping_t **p = &s21_mappings;
+    while (*p && (*p)->table != table) p = &(*p)->next;
+    if (*p) {
+      found = *p;
+      *p = found->next;
+      atomic_fetch_sub(&s21_mappings_live, 1);
+    }
+    pthread_mutex_unlock(&s21_mappings_lock);
+  }
+  if (found) {
+    munmap(found->base, found->length);
+    free(found->table);
+    free(found);
+  }
+  return found ? TRUE : FALSE;
+}
+
+int s21_matrix_verify(const char *path) {
+  size_t length = 0;
+  void *base = s21_map_file(path, &length);
+  const s21_file_header_t *h = base;
+  int ret = base ? s21_check_header(h, length) : ERROR;
+  if (ret == OK) {
+    s21_checksum_t c;
+    s21_checksum_init(&c);
+    s21_checksum_update(&c, (char *)base + h->data_offset,
+                        (size_t)h->rows * h->ld);
+    if (s21_checksum_final(&c) != h->data_checksum) ret = CALCULATION_ERROR;
+  }
+  if (base) munmap(base, length);
+  return ret;
+}
+
+size_t s21_file_offset(int columns, int row, int column) {
+  return sizeof(s21_file_header_t) +
+         ((size_t)row * s21_file_ld(columns) + column) * sizeof(double);
+}
+
+int s21_file_create(const char *path, int rows, int columns) {
+  char *tmp = s21_tmp_path(path);
+  int fd = tmp && rows > 0 && columns > 0
+               ? open(tmp, O_RDWR | O_CREAT | O_TRUNC, 0644)
+               : -1;
+  if (fd >= 0 && ftruncate(fd, s21_file_offset(columns, rows, 0))) {
+    close(fd);
+    remove(tmp);
+    fd = -1;
+  }
+  free(tmp);
+  return fd;
+}
+
+/* the data is read back for its checksum, as it was written out of order */
+static int s21_file_seal(int fd, int rows, int columns) {
+  s21_file_header_t h = s21_new_header(rows, columns);
+  double *row = calloc(h.ld, sizeof(double));
+  size_t bytes = sizeof(double) * h.ld;
+  int ret = row ? OK : ERROR;
+  s21_checksum_t c;
+  s21_checksum_init(&c);
+  for (int i = 0; i < rows && ret == OK; i++) {
+    if (pread(fd, row, bytes, s21_file_offset(columns, i, 0)) != (ssize_t)bytes)
+      ret = ERROR;
+    s21_checksum_update(&c, row, h.ld);
+  }
+  free(row);
+  if (ret == OK) {
+    h.data_checksum = s21_checksum_final(&c);
+    h.header_checksum = s21_header_checksum(&h);
+    if (pwrite(fd, &h, sizeof(h), 0) != sizeof(h)) ret = ERROR;
+  }
+  return ret;
+}
+
+int s21_file_finish(int fd, const char *path, int rows, int columns,
+                    int status) {
+  char *tmp = s21_tmp_path(path);
+  int ret = tmp ? status : ERROR;
+  if (ret == OK) ret = s21_file_seal(fd, rows, columns);
+  if (close(fd)) ret = ERROR;
+  if (ret == OK && rename(tmp, path)) ret = ERROR;
+  if (ret != OK && tmp) remove(tmp);
+  free(tmp);
+  return ret;
+}
@@ -0,0 +1,593 @@
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#include "s21_internal.h"
+
+#define S21_LU_BLOCK 64
+#define S21_NEAR_SINGULAR 1e-8
+/* fewest right-hand sides per thread of s21_solve, and the work to thread */
+#define S21_SOLVE_PANEL 64
+#define S21_SOLVE_PARALLEL (128 * 128 * 128)
+
+static double s21_max_abs(matrix_t *a) {
+  double max = 0.0;
+  for (int i = 0; i < a->rows; i++) {
+    for (int j = 0; j < a->columns; j++) {
+      double t = fabs(a->matrix[i][j]);
+      if (t > max) max = t;
+    }
+  }
+  return max;
+}
+
+static void s21_swap_int(int *a, int *b) {
+  int t = *a;
+  *a = *b;
+  *b = t;
+}
+
+struct s21_lu {
+  matrix_t lu;
+  int *perm;
+  int swaps;
+  int singular;
+};
+
+/*
+ * Unblocked elimination of columns k0..k1 over rows k0..n. A column without
+ * a usable pivot marks the factorisation singular and is left uneliminated.
+ */
+static void s21_lu_panel(s21_lu_t *f, int k0, int k1, double tol) {
+  matrix_t *lu = &f->lu;
+  int *perm = f->perm, n = lu->rows;
+  for (int k = k0; k < k1; k++) {
+    int p = k;
+    double max = fabs(lu->matrix[perm[k]][k]);
+    for (int i = k + 1; i < n; i++) {
+      double t = fabs(lu->matrix[perm[i]][k]);
+      if (t > max) {
+        max = t;
+        p = i;
+      }
+    }
+    if (max <= tol) {
+      f->singular = TRUE;
+      for (int i = k + 1; i < n; i++) lu->matrix[perm[i]][k] = 0.0;
+    } else {
+      if (p != k) {
+        s21_swap_int(perm + k, perm + p);
+        f->swaps++;
+      }
+      const double *rk = lu->matrix[perm[k]];
+      for (int i = k + 1; i < n; i++) {
+        double *ri = lu->matrix[perm[i]];
+        double l = ri[k] / rk[k];
+        ri[k] = l;
+        for (int j = k + 1; j < k1; j++) ri[j] -= l * rk[j];
+      }
+    }
+  }
+}
+
+/* blocked right-looking LU; the trailing update goes through s21_gemm */
+static int s21_lu_decompose(s21_lu_t *f) {
+  matrix_t *lu = &f->lu;
+  int *perm = f->perm, n = lu->rows;
+  double tol = n * DBL_EPSILON * s21_max_abs(lu);
+  double **t = s21_scratch_alloc(sizeof(double *) * 3 * n);
+  f->swaps = 0;
+  f->singular = FALSE;
+  for (int i = 0; i < n; i++) perm[i] = i;
+  for (int k0 = 0; k0 < n && t; k0 += S21_LU_BLOCK) {
+    int k1 = k0 + S21_LU_BLOCK < n ? k0 + S21_LU_BLOCK : n;
+    s21_lu_panel(f, k0, k1, tol);
+    if (k1 < n) {
+      double **l21 = t, **u12 = t + n, **a22 = t + 2 * n;
+      for (int i = k0 + 1; i < k1; i++) {
+        double *ri = lu->matrix[perm[i]];
+        for (int k = k0; k < i; k++) {
+          const double *rk = lu->matrix[perm[k]];
+          double f = ri[k];
+          for (int j = k1; j < n; j++) ri[j] -= f * rk[j];
+        }
+      }
+      for (int i = k1; i < n; i++) {
+        l21[i - k1] = lu->matrix[perm[i]] + k0;
+        a22[i - k1] = lu->matrix[perm[i]] + k1;
+      }
+      for (int k = k0; k < k1; k++) u12[k - k0] = lu->matrix[perm[k]] + k1;
+      s21_gemm(n - k1, n - k1, k1 - k0, -1.0, l21, u12, a22);
+    }
+  }
+  s21_scratch_free(t);
+  return t ? OK : ERROR;
+}
+
+/* x[i0..i1) -= t[i0..i1)[c0..c1) * x[c0..c1), rows of t shifted by c0 */
+static void s21_lu_update(double **t, int i0, int i1, int c0, int c1,
+                          matrix_t *x) {
+  double *shifted[S21_LU_BLOCK];
+  for (int i = i0; i < i1; i++) shifted[i - i0] = t[i] + c0;
+  s21_gemm(i1 - i0, x->columns, c1 - c0, -1.0, shifted, x->matrix + c0,
+           x->matrix + i0);
+}
+
+/*
+ * Overwrites x, which holds P * B on entry, with the solution of A x = B;
+ * row i of t is row i of the factorisation in pivot order.
+ */
+static void s21_lu_substitute_rows(double **t, matrix_t *x) {
+  int n = x->rows, m = x->columns;
+  for (int i0 = 0; i0 < n; i0 += S21_LU_BLOCK) {
+    int i1 = i0 + S21_LU_BLOCK < n ? i0 + S21_LU_BLOCK : n;
+    if (i0 > 0) s21_lu_update(t, i0, i1, 0, i0, x);
+    for (int i = i0 + 1; i < i1; i++) {
+      double *xi = x->matrix[i];
+      for (int k = i0; k < i; k++) {
+        const double *xk = x->matrix[k];
+        double f = t[i][k];
+        for (int j = 0; j < m; j++) xi[j] -= f * xk[j];
+      }
+    }
+  }
+  for (int i1 = n; i1 > 0; i1 -= S21_LU_BLOCK) {
+    int i0 = i1 - S21_LU_BLOCK > 0 ? i1 - S21_LU_BLOCK : 0;
+    if (i1 < n) s21_lu_update(t, i0, i1, i1, n, x);
+    for (int i = i1 - 1; i >= i0; i--) {
+      double *xi = x->matrix[i];
+      for (int k = i + 1; k < i1; k++) {
+        const double *xk = x->matrix[k];
+        double f = t[i][k];
+        for (int j = 0; j < m; j++) xi[j] -= f * xk[j];
+      }
+      double d = 1.0 / t[i][i];
+      for (int j = 0; j < m; j++) xi[j] *= d;
+    }
+  }
+}
+
+static double **s21_lu_rows(s21_lu_t *f) {
+  double **t = s21_scratch_alloc(sizeof(double *) * f->lu.rows);
+  for (int i = 0; t && i < f->lu.rows; i++) t[i] = f->lu.matrix[f->perm[i]];
+  return t;
+}
+
+static int s21_lu_substitute(s21_lu_t *f, matrix_t *x) {
+  double **t = s21_lu_rows(f);
+  if (t) s21_lu_substitute_rows(t, x);
+  s21_scratch_free(t);
+  return t ? OK : ERROR;
+}
+
+/* scratch factorisations live in the thread arena of the calling scope */
+static int s21_lu_factor_impl(matrix_t *a, s21_lu_t **result, int scratch) {
+  int ret = OK;
+  if (result) *result = NULL;
+  if (!result || !s21_is_valid_matrix_t(a)) {
+    ret = ERROR;
+  } else if (!s21_is_square_matrix(a)) {
+    ret = CALCULATION_ERROR;
+  } else {
+    size_t bytes = sizeof(s21_lu_t) + sizeof(int) * a->rows;
+    s21_lu_t *f = scratch ? s21_scratch_alloc(bytes) : malloc(bytes);
+    if (f) {
+      f->perm = (int *)(f + 1);
+      f->lu = scratch ? s21_scratch_copy(a) : s21_copy_matrix(a);
+    }
+    ret = f && f->lu.matrix ? s21_lu_decompose(f) : ERROR;
+    if (ret == OK) {
+      *result = f;
+    } else {
+      s21_lu_free(f);
+    }
+  }
+  return ret;
+}
+
+int s21_lu_factor(matrix_t *a, s21_lu_t **result) {
+  S21_STATS_BEGIN(S21_STATS_LU_FACTOR);
+  s21_arena_mark_t mark = s21_arena_begin();
+  int ret = s21_lu_factor_impl(a, result, FALSE);
+  s21_arena_end(mark);
+  S21_STATS_END(ret == OK ? 2.0 * a->rows * a->rows * a->rows / 3.0 : 0.0);
+  return ret;
+}
+
+void s21_lu_free(s21_lu_t *f) {
+  if (f) {
+    s21_remove_matrix(&f->lu);
+    s21_scratch_free(f);
+  }
+}
+
+int s21_lu_det(s21_lu_t *f, double *result) {
+  int ret = OK;
+  if (!f || !result) {
+    ret = ERROR;
+  } else if (f->singular) {
+    *result = 0.0;
+  } else {
+    double det = f->swaps % 2 ? -1.0 : 1.0;
+    for (int i = 0; i < f->lu.rows; i++) det *= f->lu.matrix[f->perm[i]][i];
+    *result = det;
+  }
+  return ret;
+}
+
+int s21_lu_solve(s21_lu_t *f, matrix_t *b, matrix_t *result) {
+  S21_STATS_BEGIN(S21_STATS_LU_SOLVE);
+  s21_arena_mark_t mark = s21_arena_begin();
+  int ret = OK;
+  if (!f || !result || !s21_is_valid_matrix_t(b)) {
+    ret = ERROR;
+  } else if (b->rows != f->lu.rows || f->singular) {
+    ret = CALCULATION_ERROR;
+  } else {
+    ret = s21_create_matrix(b->rows, b->columns, result);
+    for (int i = 0; i < b->rows && ret == OK; i++) {
+      memcpy(result->matrix[i], b->matrix[f->perm[i]],
+             sizeof(double) * b->columns);
+    }
+    if (ret == OK) ret = s21_lu_substitute(f, result);
+  }
+  s21_arena_end(mark);
+  S21_STATS_END(ret == OK ? 2.0 * b->rows * b->rows * b->columns : 0.0);
+  return ret;
+}
+
+int s21_lu_solve_vector(s21_lu_t *f, const double *b, double *x) {
+  S21_STATS_BEGIN(S21_STATS_LU_SOLVE);
+  int ret = OK;
+  if (!f || !b || !x) {
+    ret = ERROR;
+  } else if (f->singular) {
+    ret = CALCULATION_ERROR;
+  } else {
+    int n = f->lu.rows;
+    for (int i = 0; i < n; i++) {
+      const double *li = f->lu.matrix[f->perm[i]];
+      double s = b[f->perm[i]];
+      for (int k = 0; k < i; k++) s -= li[k] * x[k];
+      x[i] = s;
+    }
+    for (int i = n - 1; i >= 0; i--) {
+      const double *ui = f->lu.matrix[f->perm[i]];
+      double s = x[i];
+      for (int k = i + 1; k < n; k++) s -= ui[k] * x[k];
+      x[i] = s / ui[i];
+    }
+  }
+  S21_STATS_END(ret == OK ? 2.0 * f->lu.rows * f->lu.rows : 0.0);
+  return ret;
+}
+
+static int s21_lu_inverse_impl(s21_lu_t *f, matrix_t *result, int reuse) {
+  int ret = OK;
+  if (!f || !result) {
+    ret = ERROR;
+  } else if (f->singular) {
+    ret = CALCULATION_ERROR;
+  } else {
+    int n = f->lu.rows;
+    ret = reuse ? s21_reserve_matrix(n, n, result)
+                : s21_create_matrix(n, n, result);
+    if (ret == OK) {
+      for (int i = 0; i < n; i++) {
+        if (reuse) memset(result->matrix[i], 0, sizeof(double) * n);
+        result->matrix[i][f->perm[i]] = 1.0;
+      }
+      ret = s21_lu_substitute(f, result);
+    }
+  }
+  return ret;
+}
+
+int s21_lu_inverse(s21_lu_t *f, matrix_t *result) {
+  S21_STATS_BEGIN(S21_STATS_INVERSE_MATRIX);
+  s21_arena_mark_t mark = s21_arena_begin();
+  int ret = s21_lu_inverse_impl(f, result, FALSE);
+  s21_arena_end(mark);
+  S21_STATS_END(ret == OK ? 4.0 * f->lu.rows * f->lu.rows * f->lu.rows / 3.0
+                          : 0.0);
+  return ret;
+}
+
+int s21_determinant(matrix_t *a, double *result) {
+  S21_STATS_BEGIN(S21_STATS_DETERMINANT);
+  s21_arena_mark_t mark = s21_arena_begin();
+  s21_lu_t *f = NULL;
+  double det = 0.0;
+  int ret = result ? OK : ERROR;
+  int spd = ret == OK && s21_spd_determinant(a, &det) == OK;
+  if (ret == OK && !spd) ret = s21_lu_factor_impl(a, &f, TRUE);
+  if (ret == OK && !spd) s21_lu_det(f, &det);
+  if (ret == OK) {
+    if (s21_equal_double(0.0, det)) det *= det;
+    *result = det;
+  }
+  s21_lu_free(f);
+  s21_arena_end(mark);
+  S21_STATS_END(ret == OK
+                    ? (spd ? 1.0 : 2.0) * a->rows * a->rows * a->rows / 3.0
+                    : 0.0);
+  return ret;
+}
+
+static int s21_inverse_impl(matrix_t *a, matrix_t *result, int reuse) {
+  S21_STATS_BEGIN(S21_STATS_INVERSE_MATRIX);
+  s21_arena_mark_t mark = s21_arena_begin();
+  s21_lu_t *f = NULL;
+  int ret = result ? OK : ERROR;
+  int spd = ret == OK && s21_spd_inverse(a, result, reuse) == OK;
+  if (ret == OK && !spd) ret = s21_lu_factor_impl(a, &f, TRUE);
+  if (ret == OK && !spd) ret = s21_lu_inverse_impl(f, result, reuse);
+  s21_lu_free(f);
+  s21_arena_end(mark);
+  S21_STATS_END(ret == OK ? (spd ? 1.0 : 2.0) * a->rows * a->rows * a->rows
+                          : 0.0);
+  return ret;
+}
+
+int s21_inverse_matrix(matrix_t *a, matrix_t *result) {
+  return s21_inverse_impl(a, result, FALSE);
+}
+
+int s21_inverse_matrix_into(matrix_t *a, matrix_t *result) {
+  return s21_inverse_impl(a, result, TRUE);
+}
+
+/* one factorisation applied to column panels of x, Cholesky when t is NULL */
+typedef struct {
+  double **t;
+  matrix_t *l, *lt;
+  matrix_t *x;
+  double **views;
+  int width;
+} s21_solve_job_t;
+
+static void s21_solve_panel(void *ctx, int task) {
+  s21_solve_job_t *job = ctx;
+  int n = job->x->rows, c0 = task * job->width, m = job->x->columns - c0;
+  double **rows = job->views + (size_t)task * n;
+  for (int i = 0; i < n; i++) rows[i] = job->x->matrix[i] + c0;
+  matrix_t view = {rows, n, m < job->width ? m : job->width};
+  if (job->t)
+    s21_lu_substitute_rows(job->t, &view);
+  else
+    s21_cholesky_substitute(job->l, job->lt, &view);
+}
+
+/* panels are a multiple of 8 columns wide, so padded view rows stay aligned */
+static int s21_solve_width(int n, int m) {
+  int panels = 1;
+  if ((double)n * n * m >= S21_SOLVE_PARALLEL) {
+    panels = s21_get_num_threads();
+    if (panels > m / S21_SOLVE_PANEL) panels = m / S21_SOLVE_PANEL;
+    if (panels < 1) panels = 1;
+  }
+  int width = (m + panels - 1) / panels;
+  return (width + 7) / 8 * 8;
+}
+
+int s21_solve(matrix_t *a, matrix_t *b, matrix_t *result) {
+  S21_STATS_BEGIN(S21_STATS_SOLVE);
+  s21_arena_mark_t mark = s21_arena_begin();
+  int ret = result && s21_is_valid_matrix_t(a) && s21_is_valid_matrix_t(b)
+                ? OK
+                : ERROR;
+  if (ret == OK && (!s21_is_square_matrix(a) || b->rows != a->rows))
+    ret = CALCULATION_ERROR;
+  s21_lu_t *f = NULL;
+  matrix_t l = {0}, lt = {0};
+  s21_solve_job_t job = {.l = &l, .lt = &lt, .x = result};
+  int spd = ret == OK && s21_spd_factor(a, &l) == OK, panels = 0;
+  if (spd) {
+    ret = s21_scratch_matrix(l.rows, l.rows, &lt);
+    if (ret == OK) s21_transpose_rows(l.matrix, l.rows, l.rows, lt.matrix);
+  } else if (ret == OK) {
+    ret = s21_lu_factor_impl(a, &f, TRUE);
+    if (ret == OK && f->singular) ret = CALCULATION_ERROR;
+    if (ret == OK && !(job.t = s21_lu_rows(f))) ret = ERROR;
+  }
+  if (ret == OK) {
+    job.width = s21_solve_width(a->rows, b->columns);
+    panels = (b->columns + job.width - 1) / job.width;
+    job.views = s21_scratch_alloc(sizeof(double *) * a->rows * panels);
+    ret = job.views ? s21_create_matrix(b->rows, b->columns, result) : ERROR;
+  }
+  if (ret == OK) {
+    for (int i = 0; i < b->rows; i++)
+      memcpy(result->matrix[i], b->matrix[spd ? i : f->perm[i]],
+             sizeof(double) * b->columns);
+    s21_parallel_for(panels, s21_solve_panel, &job);
+  }
+  s21_scratch_free(job.views);
+  s21_scratch_free(job.t);
+  s21_remove_matrix(&lt);
+  s21_remove_matrix(&l);
+  s21_lu_free(f);
+  s21_arena_end(mark);
+  S21_STATS_END(ret == OK ? ((spd ? 1.0 : 2.0) * a->rows / 3.0 +
+                             2.0 * b->columns) * a->rows * a->rows
+                          : 0.0);
+  return ret;
+}
+
+/*
+ * Complete pivoting P A Q = L U on a private copy, swapping rows and columns
+ * in place. Stops at the first pivot below tol and returns the rank found.
+ */
+static int s21_lu_full(matrix_t *u, int *rperm, int *cperm, int *sign,
+                       double tol) {
+  int n = u->rows, rank = n;
+  *sign = 1;
+  for (int i = 0; i < n; i++) rperm[i] = cperm[i] = i;
+  for (int k = 0; k < n && rank == n; k++) {
+    int p = k, q = k;
+    double max = -1.0;
+    for (int i = k; i < n; i++) {
+      for (int j = k; j < n; j++) {
+        double t = fabs(u->matrix[i][j]);
+        if (t > max) {
+          max = t;
+          p = i;
+          q = j;
+        }
+      }
+    }
+    if (p != k) {
+      double *t = u->matrix[k];
+      u->matrix[k] = u->matrix[p];
+      u->matrix[p] = t;
+      s21_swap_int(rperm + k, rperm + p);
+      *sign = -*sign;
+    }
+    if (q != k) {
+      for (int i = 0; i < n; i++) {
+        double t = u->matrix[i][k];
+        u->matrix[i][k] = u->matrix[i][q];
+        u->matrix[i][q] = t;
+      }
+      s21_swap_int(cperm + k, cperm + q);
+      *sign = -*sign;
+    }
+    if (max <= tol) {
+      rank = k;
+    } else {
+      const double *rk = u->matrix[k];
+      for (int i = k + 1; i < n; i++) {
+        double *ri = u->matrix[i];
+        double f = ri[k] / rk[k];
+        ri[k] = f;
+        for (int j = k + 1; j < n; j++) ri[j] -= f * rk[j];
+      }
+    }
+  }
+  return rank;
+}
+
+/*
+ * With U = [U11 u; 0 d] the adjugate is
+ * det(U11) * (d * [inv(U11) 0; 0 0] + x e_n^T), x = [-inv(U11) u; 1],
+ * which stays exact as d goes to zero, and adj(A) = +-Q adj(U) inv(L) P.
+ */
+static int s21_complements_rank_aware(matrix_t *a, matrix_t *result,
+                                      double tol) {
+  int n = a->rows, sign = 1, rank = 0;
+  int *perm = s21_scratch_alloc(sizeof(int) * 2 * n);
+  double *x = s21_scratch_alloc(sizeof(double) * n);
+  matrix_t u = s21_scratch_copy(a), m = {0};
+  int ret = perm && x && u.matrix ? s21_scratch_matrix(n, n, &m) : ERROR;
+  if (ret == OK) rank = s21_lu_full(&u, perm, perm + n, &sign, tol);
+  for (int i = 0; i < n && ret == OK && rank < n - 1; i++) {
+    memset(result->matrix[i], 0, sizeof(double) * n);
+  }
+  if (ret == OK && rank >= n - 1) {
+    double det = 1.0, d = u.matrix[n - 1][n - 1];
+    for (int i = 0; i < n; i++) {
+      m.matrix[i][i] = 1.0;
+      for (int k = 0; k < i; k++) {
+        double f = u.matrix[i][k];
+        for (int j = 0; j <= k; j++) m.matrix[i][j] -= f * m.matrix[k][j];
+      }
+    }
+    x[n - 1] = 1.0;
+    for (int i = n - 2; i >= 0; i--) {
+      const double *ui = u.matrix[i];
+      double s = ui[n - 1];
+      for (int k = i + 1; k < n - 1; k++) {
+        s += ui[k] * x[k];
+        for (int j = 0; j < n; j++) m.matrix[i][j] -= ui[k] * m.matrix[k][j];
+      }
+      x[i] = -s / ui[i];
+      for (int j = 0; j < n; j++) m.matrix[i][j] /= ui[i];
+      det *= ui[i];
+    }
+    const double *y = m.matrix[n - 1];
+    for (int i = 0; i < n - 1; i++) {
+      for (int j = 0; j < n; j++) {
+        m.matrix[i][j] = det * (d * m.matrix[i][j] + x[i] * y[j]);
+      }
+    }
+    for (int j = 0; j < n; j++) m.matrix[n - 1][j] *= det;
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) {
+        result->matrix[perm[i]][perm[n + j]] = sign * m.matrix[j][i];
+      }
+    }
+  }
+  s21_remove_matrix(&m);
+  s21_remove_matrix(&u);
+  s21_scratch_free(perm);
+  s21_scratch_free(x);
+  return ret;
+}
+
+/* cofactors of a well conditioned matrix are det(A) * inv(A)^T */
+static int s21_complements_adjugate(matrix_t *a, matrix_t *result,
+                                    double ratio) {
+  int n = a->rows;
+  s21_lu_t *f = NULL;
+  matrix_t inv = {0};
+  int ret = s21_lu_factor_impl(a, &f, TRUE);
+  if (ret == OK) {
+    double det = 0.0, min = INFINITY, max = 0.0;
+    s21_lu_det(f, &det);
+    for (int i = 0; i < n; i++) {
+      double t = fabs(f->lu.matrix[f->perm[i]][i]);
+      min = fmin(min, t);
+      max = fmax(max, t);
+    }
+    if (f->singular || min <= ratio * max || !isfinite(det))
+      ret = CALCULATION_ERROR;
+    if (ret == OK) ret = s21_scratch_matrix(n, n, &inv);
+    if (ret == OK) ret = s21_lu_inverse_impl(f, &inv, TRUE);
+    for (int i = 0; i < n && ret == OK; i++) {
+      for (int j = 0; j < n; j++) {
+        result->matrix[i][j] = det * inv.matrix[j][i];
+      }
+    }
+  }
+  s21_remove_matrix(&inv);
+  s21_lu_free(f);
+  return ret;
+}
+
+static int s21_complements_impl(matrix_t *a, matrix_t *result, int reuse) {
+  S21_STATS_BEGIN(S21_STATS_CALC_COMPLEMENTS);
+  int ret = OK;
+  double flops = 0.0;
+  if (!result || !s21_is_valid_matrix_t(a)) {
+    ret = ERROR;
+  } else if (s21_is_square_matrix(a)) {
+    int n = a->rows;
+    double tol = n * DBL_EPSILON * s21_max_abs(a);
+    flops = 2.0 * n * n * n;
+    ret = reuse ? s21_reserve_matrix(n, n, result)
+                : s21_create_matrix(n, n, result);
+    if (ret == OK && n == 1) {
+      result->matrix[0][0] = 1.0;
+    } else if (ret == OK) {
+      s21_arena_mark_t mark = s21_arena_begin();
+      if (s21_complements_adjugate(a, result, S21_NEAR_SINGULAR) != OK) {
+        s21_arena_end(mark);
+        ret = s21_complements_rank_aware(a, result, tol);
+      }
+      s21_arena_end(mark);
+    }
+    if (ret != OK && !reuse) s21_remove_matrix(result);
+  } else {
+    ret = CALCULATION_ERROR;
+  }
+  S21_STATS_END(ret == OK ? flops : 0.0);
+  return ret;
+}
+
+int s21_calc_complements(matrix_t *a, matrix_t *result) {
+  return s21_complements_impl(a, result, FALSE);
+}
+
+int s21_calc_complements_into(matrix_t *a, matrix_t *result) {
+  return s21_complements_impl(a, result, TRUE);
+}
@@ -1,6 +1,11 @@
 #include "s21_matrix.h"
 
+#include <limits.h>
 #include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "s21_internal.h"
 
 int s21_is_valid_matrix_t(matrix_t *a) {
   return a && a->matrix && a->rows > 0 && a->columns > 0;
@@ -12,35 +17,118 @@ int s21_equal_double(double a, double b) {
   return a - b < 1e-7 && a - b > -1e-7;
 }
 
+size_t s21_row_table_bytes(int rows) {
+  size_t bytes = (size_t)rows * sizeof(double *);
+  return (bytes + S21_ALIGN - 1) / S21_ALIGN * S21_ALIGN;
+}
+
+/* rows narrower than a cache line stay packed, padding would dwarf them */
+int s21_leading_dim(int columns) {
+  int per_line = S21_ALIGN / sizeof(double);
+  return columns < per_line ? columns
+                            : (columns + per_line - 1) / per_line * per_line;
+}
+
+/* the data of a block starts at the first cache line past its row table */
+double *s21_matrix_data(double **matrix, int rows) {
+  return (double *)((char *)matrix + s21_row_table_bytes(rows));
+}
+
+/* whole cache lines, as aligned_alloc wants and packed rows may not fill */
+size_t s21_block_bytes(int rows, int columns) {
+  size_t data = (size_t)rows * (size_t)s21_leading_dim(columns);
+  size_t table = s21_row_table_bytes(rows);
+  return data <= (SIZE_MAX - table - S21_ALIGN) / sizeof(double)
+             ? (table + data * sizeof(double) + S21_ALIGN - 1) / S21_ALIGN *
+                   S21_ALIGN
+             : 0;
+}
+
+void s21_layout_rows(double **matrix, int rows, int columns) {
+  int ld = s21_leading_dim(columns);
+  double *block = s21_matrix_data(matrix, rows);
+  for (int i = 0; i < rows; i++) {
+    matrix[i] = block + (size_t)i * ld;
+  }
+}
+
 int s21_create_matrix(int rows, int columns, matrix_t *result) {
+  S21_STATS_BEGIN(S21_STATS_CREATE_MATRIX);
   int ret = OK;
-  if (!result || rows <= 0 || columns <= 0) {
+  if (!result || rows <= 0 || columns <= 0 ||
+      columns > INT_MAX - S21_ALIGN) {
     ret = ERROR;
   } else {
-    double **matrix = calloc(rows, sizeof(double *));
+    size_t bytes = s21_block_bytes(rows, columns);
+    double **matrix = bytes ? aligned_alloc(S21_ALIGN, bytes) : NULL;
     if (matrix) {
-      for (int i = 0; i < rows; i++) {
-        matrix[i] = calloc(columns, sizeof(double));
-      }
+      memset(s21_matrix_data(matrix, rows), 0,
+             bytes - s21_row_table_bytes(rows));
+      s21_layout_rows(matrix, rows, columns);
       result->matrix = matrix;
       result->rows = rows;
       result->columns = columns;
+      S21_STATS_ALLOC(bytes);
     } else
       ret = ERROR;
   }
+  S21_STATS_END(0);
+  return ret;
+}
+
+/* a mapped matrix has no block behind its row table and is never reused */
+int s21_reserve_matrix(int rows, int columns, matrix_t *result) {
+  int ret = OK;
+  if (!result || rows <= 0 || columns <= 0 ||
+      columns > INT_MAX - S21_ALIGN) {
+    ret = ERROR;
+  } else if (!s21_is_valid_matrix_t(result)) {
+    ret = s21_create_matrix(rows, columns, result);
+  } else if (s21_is_mapped(result->matrix)) {
+    ret = ERROR;
+  } else if (result->rows != rows || result->columns != columns) {
+    size_t bytes = s21_block_bytes(rows, columns);
+    if (bytes && bytes <= s21_block_bytes(result->rows, result->columns)) {
+      s21_layout_rows(result->matrix, rows, columns);
+      result->rows = rows;
+      result->columns = columns;
+    } else {
+      s21_remove_matrix(result);
+      ret = s21_create_matrix(rows, columns, result);
+    }
+  }
   return ret;
 }
 
+static int s21_prepare_result(int rows, int columns, matrix_t *result,
+                              int reuse) {
+  return reuse ? s21_reserve_matrix(rows, columns, result)
+               : s21_create_matrix(rows, columns, result);
+}
+
+/* moves the storage of from into to, releasing what to held */
+static void s21_replace_matrix(matrix_t *to, matrix_t *from) {
+  if (to != from) {
+    s21_remove_matrix(to);
+    *to = *from;
+  }
+}
+
+static int s21_shares_storage(matrix_t *a, matrix_t *b) {
+  return s21_is_valid_matrix_t(a) && s21_is_valid_matrix_t(b) &&
+         a->matrix == b->matrix;
+}
+
 void s21_remove_matrix(matrix_t *a) {
+  S21_STATS_BEGIN(S21_STATS_REMOVE_MATRIX);
   if (a && s21_is_valid_matrix_t(a)) {
-    for (int i = 0; i < a->rows; i++) {
-      free(a->matrix[i]);
-    }
-    free(a->matrix);
+    if (!s21_arena_owns(a->matrix) && !s21_unmap_matrix(a->matrix))
+      free(a->matrix);
     a->matrix = NULL;
     a->rows = 0;
     a->columns = 0;
   }
+  S21_STATS_END(0);
 }
 
 int s21_equal_dims(matrix_t *a, matrix_t *b) {
@@ -49,243 +137,168 @@ int s21_equal_dims(matrix_t *a, matrix_t *b) {
 }
 
 int s21_eq_matrix(matrix_t *a, matrix_t *b) {
+  S21_STATS_BEGIN(S21_STATS_EQ_MATRIX);
   int ret = FALSE;
   if (s21_equal_dims(a, b)) {
     ret = TRUE;
     for (int i = 0; i < a->rows && ret == TRUE; i++) {
-      for (int j = 0; j < a->columns && ret == TRUE; j++) {
-        if (!s21_equal_double(a->matrix[i][j], b->matrix[i][j])) {
-          ret = FALSE;
-        }
-      }
+      ret = s21_kernels->eq(a->matrix[i], b->matrix[i], a->columns);
     }
   }
+  S21_STATS_END(ret ? (double)a->rows * a->columns : 0.0);
   return ret;
 }
 
-int s21_sum_matrix(matrix_t *a, matrix_t *b, matrix_t *result) {
+static int s21_elementwise(matrix_t *a, matrix_t *b, matrix_t *result,
+                           int sub, int reuse) {
+  S21_STATS_BEGIN(sub ? S21_STATS_SUB_MATRIX : S21_STATS_SUM_MATRIX);
   int ret = OK;
   if (!result || !s21_is_valid_matrix_t(a) || !s21_is_valid_matrix_t(b)) {
     ret = ERROR;
   } else if (a->rows == b->rows && a->columns == b->columns) {
-    s21_create_matrix(a->rows, a->columns, result);
-    for (int i = 0; i < a->rows; i++) {
-      for (int j = 0; j < a->columns; j++) {
-        result->matrix[i][j] = a->matrix[i][j] + b->matrix[i][j];
-      }
+    ret = s21_prepare_result(a->rows, a->columns, result, reuse);
+    for (int i = 0; i < a->rows && ret == OK; i++) {
+      if (sub)
+        s21_kernels->sub(a->matrix[i], b->matrix[i], result->matrix[i],
+                         a->columns);
+      else
+        s21_kernels->add(a->matrix[i], b->matrix[i], result->matrix[i],
+                         a->columns);
     }
   } else {
     ret = CALCULATION_ERROR;
   }
+  S21_STATS_END(ret == OK ? (double)a->rows * a->columns : 0.0);
   return ret;
 }
 
+int s21_sum_matrix(matrix_t *a, matrix_t *b, matrix_t *result) {
+  return s21_elementwise(a, b, result, FALSE, FALSE);
+}
+
+int s21_sum_matrix_into(matrix_t *a, matrix_t *b, matrix_t *result) {
+  return s21_elementwise(a, b, result, FALSE, TRUE);
+}
+
 int s21_sub_matrix(matrix_t *a, matrix_t *b, matrix_t *result) {
-  int ret = OK;
-  if (!result || !s21_is_valid_matrix_t(a) || !s21_is_valid_matrix_t(b)) {
-    ret = ERROR;
-  } else if (a->rows == b->rows && a->columns == b->columns) {
-    s21_create_matrix(a->rows, a->columns, result);
-    for (int i = 0; i < a->rows; i++) {
-      for (int j = 0; j < a->columns; j++) {
-        result->matrix[i][j] = a->matrix[i][j] - b->matrix[i][j];
-      }
-    }
-  } else {
-    ret = CALCULATION_ERROR;
-  }
-  return ret;
+  return s21_elementwise(a, b, result, TRUE, FALSE);
 }
 
-int s21_mult_number(matrix_t *a, double number, matrix_t *result) {
+int s21_sub_matrix_into(matrix_t *a, matrix_t *b, matrix_t *result) {
+  return s21_elementwise(a, b, result, TRUE, TRUE);
+}
+
+static int s21_scale(matrix_t *a, double number, matrix_t *result,
+                     int reuse) {
+  S21_STATS_BEGIN(S21_STATS_MULT_NUMBER);
   int ret = OK;
   if (!result || !s21_is_valid_matrix_t(a)) {
     ret = ERROR;
   } else {
-    if (a != result) s21_create_matrix(a->rows, a->columns, result);
-    for (int i = 0; i < a->rows; i++) {
-      for (int j = 0; j < a->columns; j++) {
-        result->matrix[i][j] = a->matrix[i][j] * number;
-      }
+    if (a != result)
+      ret = s21_prepare_result(a->rows, a->columns, result, reuse);
+    for (int i = 0; i < a->rows && ret == OK; i++) {
+      s21_kernels->scale(a->matrix[i], number, result->matrix[i], a->columns);
     }
   }
+  S21_STATS_END(ret == OK ? (double)a->rows * a->columns : 0.0);
   return ret;
 }
 
-int s21_mult_matrix(matrix_t *a, matrix_t *b, matrix_t *result) {
+int s21_mult_number(matrix_t *a, double number, matrix_t *result) {
+  return s21_scale(a, number, result, FALSE);
+}
+
+int s21_mult_number_into(matrix_t *a, double number, matrix_t *result) {
+  return s21_scale(a, number, result, TRUE);
+}
+
+static int s21_product(matrix_t *a, matrix_t *b, matrix_t *result,
+                       int reuse) {
+  S21_STATS_BEGIN(S21_STATS_MULT_MATRIX);
   int ret = OK;
+  double flops = 0.0;
   if (!result || !s21_is_valid_matrix_t(a) || !s21_is_valid_matrix_t(b)) {
     ret = ERROR;
   } else if (a->columns == b->rows) {
-    s21_create_matrix(a->rows, b->columns, result);
-    for (int i = 0; i < a->rows; i++) {
-      for (int j = 0; j < b->columns; j++) {
-        for (int r = 0; r < b->rows; r++) {
-          result->matrix[i][j] += a->matrix[i][r] * b->matrix[r][j];
-        }
-      }
+    flops = 2.0 * a->rows * a->columns * b->columns;
+    matrix_t temp = {0}, *c = result;
+    if (reuse &&
+        (s21_shares_storage(result, a) || s21_shares_storage(result, b)))
+      c = &temp;
+    ret = s21_prepare_result(a->rows, b->columns, c, reuse && c == result);
+    if (ret == OK && c == result && reuse) {
+      for (int i = 0; i < c->rows; i++)
+        memset(c->matrix[i], 0, sizeof(double) * c->columns);
     }
+    if (ret == OK && !s21_strassen(a->rows, b->columns, a->columns, a->matrix,
+                                   b->matrix, c->matrix))
+      s21_gemm(a->rows, b->columns, a->columns, 1.0, a->matrix, b->matrix,
+               c->matrix);
+    if (ret == OK) s21_replace_matrix(result, c);
   } else {
     ret = CALCULATION_ERROR;
   }
+  S21_STATS_END(ret == OK ? flops : 0.0);
   return ret;
 }
 
-int s21_transpose(matrix_t *a, matrix_t *result) {
-  int ret = OK;
-  if (!result || !s21_is_valid_matrix_t(a))
-    ret = ERROR;
-  else {
-    s21_create_matrix(a->columns, a->rows, result);
-    for (int i = 0; i < a->rows; i++) {
-      for (int j = 0; j < a->columns; j++) {
-        result->matrix[j][i] = a->matrix[i][j];
-      }
-    }
-  }
-  return ret;
-}
-
-void swap_ptr(void **p, void **r) {
-  if (p && r) {
-    void *temp = *p;
-    *p = *r;
-    *r = temp;
-  }
+int s21_mult_matrix(matrix_t *a, matrix_t *b, matrix_t *result) {
+  return s21_product(a, b, result, FALSE);
 }
 
-int s21_new_triangle_matrix(matrix_t *a) {
-  int ret = 0;
-  int h = 0, k = 0;
-  while (h < a->rows && k < a->columns) {
-    double max = fabs(a->matrix[h][k]);
-    int i_max = h;
-    for (int i = i_max + 1; i < a->rows; i++) {
-      double t = fabs(a->matrix[i][k]);
-      if (t > max) {
-        max = t;
-        i_max = i;
-      }
-    }
-    if (s21_equal_double(a->matrix[i_max][k], 0.0)) {
-      k++;
-    } else {
-      if (h != i_max) {
-        swap_ptr((void **)&a->matrix[h], (void **)&a->matrix[i_max]);
-        ret++;
-      }
-      for (int i = h + 1; i < a->rows; i++) {
-        double f = a->matrix[i][k] / a->matrix[h][k];
-        a->matrix[i][k] = 0;
-        for (int j = k + 1; j < a->columns; j++) {
-          a->matrix[i][j] -= a->matrix[h][j] * f;
-        }
-      }
-      h++;
-      k++;
-    }
-  }
-  return ret;
+int s21_mult_matrix_into(matrix_t *a, matrix_t *b, matrix_t *result) {
+  return s21_product(a, b, result, TRUE);
 }
 
-double s21_minor_matrix_det(matrix_t *a, int i, int j) {
-  double ret = 0.0;
-  matrix_t minor = {0};
-  s21_create_matrix(a->rows - 1, a->columns - 1, &minor);
-  int rows = 0;
-  int columns = 0;
-  for (int k = 0; k < a->rows; k++) {
-    if (k == i) continue;
-    for (int m = 0; m < a->columns; m++) {
-      if (m == j) continue;
-      minor.matrix[rows][columns] = a->matrix[k][m];
-      columns++;
-    }
-    columns = 0;
-    rows++;
-  }
-  if (rows == 0) {
-    ret = 1.0;
-  } else {
-    s21_determinant(&minor, &ret);
-    ret = (i + j) % 2 == 1 ? -ret : ret;
-  }
-  s21_remove_matrix(&minor);
-  if (s21_equal_double(0.0, ret)) ret *= ret;
-  return ret;
-}
-
-int s21_calc_complements(matrix_t *a, matrix_t *result) {
+static int s21_transpose_impl(matrix_t *a, matrix_t *result, int reuse) {
+  S21_STATS_BEGIN(S21_STATS_TRANSPOSE);
   int ret = OK;
   if (!result || !s21_is_valid_matrix_t(a)) {
     ret = ERROR;
-  } else if (s21_is_square_matrix(a)) {
-    s21_create_matrix(a->rows, a->columns, result);
-    for (int i = 0; i < a->rows; i++) {
-      for (int j = 0; j < a->columns; j++) {
-        result->matrix[i][j] = s21_minor_matrix_det(a, i, j);
-      }
-    }
+  } else if (reuse && s21_shares_storage(a, result) &&
+             s21_is_square_matrix(a)) {
+    s21_transpose_square(result->matrix, result->rows);
   } else {
-    ret = CALCULATION_ERROR;
+    matrix_t temp = {0}, *c = result;
+    if (reuse && s21_shares_storage(a, result)) c = &temp;
+    ret = s21_prepare_result(a->columns, a->rows, c, reuse && c == result);
+    if (ret == OK) {
+      s21_transpose_rows(a->matrix, a->rows, a->columns, c->matrix);
+      s21_replace_matrix(result, c);
+    }
   }
+  S21_STATS_END(0);
   return ret;
 }
 
-matrix_t s21_copy_matrix(matrix_t *a) {
-  matrix_t ret = {0};
-  s21_create_matrix(a->rows, a->columns, &ret);
-  for (int i = 0; i < a->rows; i++) {
-    for (int j = 0; j < a->columns; j++) {
-      ret.matrix[i][j] = a->matrix[i][j];
-    }
-  }
-  return ret;
+int s21_transpose(matrix_t *a, matrix_t *result) {
+  return s21_transpose_impl(a, result, FALSE);
 }
 
-int s21_determinant(matrix_t *a, double *result) {
+int s21_transpose_into(matrix_t *a, matrix_t *result) {
+  return s21_transpose_impl(a, result, TRUE);
+}
+
+int s21_transpose_inplace(matrix_t *A) {
+  S21_STATS_BEGIN(S21_STATS_TRANSPOSE);
   int ret = OK;
-  if (!result || !s21_is_valid_matrix_t(a))
+  if (!s21_is_valid_matrix_t(A)) {
     ret = ERROR;
-  else if (s21_is_square_matrix(a)) {
-    double det = 1.0;
-    matrix_t copy = s21_copy_matrix(a);
-    int swap = s21_new_triangle_matrix(&copy);
-    for (int i = 0; i < copy.rows; i++) {
-      det *= copy.matrix[i][i];
-    }
-
-    s21_remove_matrix(&copy);
-    if (swap % 2 == 1) {
-      det = -det;
-    }
-    if (s21_equal_double(0.0, det)) det *= det;
-    *result = det;
-  } else
+  } else if (!s21_is_square_matrix(A)) {
     ret = CALCULATION_ERROR;
+  } else {
+    s21_transpose_square(A->matrix, A->rows);
+  }
+  S21_STATS_END(0);
   return ret;
 }
 
-int s21_inverse_matrix(matrix_t *a, matrix_t *result) {
-  int ret = OK;
-  if (!result || !s21_is_valid_matrix_t(a)) {
-    ret = ERROR;
-  } else {
-    double det = 0;
-    ret = s21_determinant(a, &det);
-    int det_is_zero = s21_equal_double(det, 0.0);
-    if (!det_is_zero && ret == OK && a->rows == 1) {
-      s21_create_matrix(1, 1, result);
-      result->matrix[0][0] = 1. / det;
-    } else if (!det_is_zero && ret == OK) {
-      matrix_t temp = {0};
-      s21_calc_complements(a, result);
-      s21_transpose(result, &temp);
-      s21_remove_matrix(result);
-      s21_mult_number(&temp, 1. / det, result);
-      s21_remove_matrix(&temp);
-    } else {
-      ret = CALCULATION_ERROR;
+matrix_t s21_copy_matrix(matrix_t *a) {
+  matrix_t ret = {0};
+  if (s21_create_matrix(a->rows, a->columns, &ret) == OK) {
+    for (int i = 0; i < a->rows; i++) {
+      memcpy(ret.matrix[i], a->matrix[i], a->columns * sizeof(double));
     }
   }
   return ret;
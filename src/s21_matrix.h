@@ -3,6 +3,22 @@
 
 #include <stdlib.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the public API stays visible when the library builds with hidden
+ * visibility; s21_matrix.map then versions these symbols */
+#ifdef __GNUC__
+#pragma GCC visibility push(default)
+#endif
+
+/*
+ * Elements live in one 64-byte aligned block allocated together with the
+ * row table: row i starts at matrix[i], rows are s21_leading_dim(columns)
+ * doubles apart. From 8 columns up that is a multiple of 8, so every row
+ * starts on a cache line; narrower rows are packed.
+ */
 typedef struct matrix_struct {
   double **matrix;
   int rows;
@@ -15,8 +31,23 @@ typedef struct matrix_struct {
 #define FALSE 0
 #define TRUE 1
 
+#define S21_ALIGN 64
+
+#define S21_ISA_SCALAR 0
+#define S21_ISA_SSE2 1
+#define S21_ISA_AVX2 2
+#define S21_ISA_AVX512 3
+
+typedef struct s21_lu s21_lu_t;
+
+typedef struct {
+  void *chunk;
+  size_t used;
+} s21_arena_mark_t;
+
 int s21_create_matrix(int, int, matrix_t *);
 void s21_remove_matrix(matrix_t *);
+int s21_leading_dim(int);
 int s21_eq_matrix(matrix_t *, matrix_t *);
 int s21_sum_matrix(matrix_t *, matrix_t *, matrix_t *);
 int s21_sub_matrix(matrix_t *, matrix_t *, matrix_t *);
@@ -27,4 +58,239 @@ int s21_calc_complements(matrix_t *, matrix_t *);
 int s21_determinant(matrix_t *, double *);
 int s21_inverse_matrix(matrix_t *, matrix_t *);
 
+/*
+ * Same operations writing into a result that is either zero-initialised or
+ * holds a matrix: its storage is reused when the new shape fits and the
+ * result may alias an input.
+ */
+int s21_sum_matrix_into(matrix_t *, matrix_t *, matrix_t *);
+int s21_sub_matrix_into(matrix_t *, matrix_t *, matrix_t *);
+int s21_mult_number_into(matrix_t *, double, matrix_t *);
+int s21_mult_matrix_into(matrix_t *, matrix_t *, matrix_t *);
+int s21_transpose_into(matrix_t *, matrix_t *);
+/* square matrices only, without a second allocation */
+int s21_transpose_inplace(matrix_t *);
+int s21_calc_complements_into(matrix_t *, matrix_t *);
+int s21_inverse_matrix_into(matrix_t *, matrix_t *);
+
+/*
+ * Partial pivoting LU kept for reuse. A singular matrix still factors:
+ * its determinant is 0 and solve/inverse return CALCULATION_ERROR.
+ */
+int s21_lu_factor(matrix_t *, s21_lu_t **);
+void s21_lu_free(s21_lu_t *);
+int s21_lu_det(s21_lu_t *, double *);
+int s21_lu_solve(s21_lu_t *, matrix_t *, matrix_t *);
+/* b and x must not overlap */
+int s21_lu_solve_vector(s21_lu_t *, const double *, double *);
+int s21_lu_inverse(s21_lu_t *, matrix_t *);
+
+/*
+ * X = inv(A) B without forming the inverse: blocked partial pivoting LU, or
+ * Cholesky as for s21_determinant, then triangular solves run in parallel
+ * over panels of the right-hand side columns. CALCULATION_ERROR when A is
+ * singular or the shapes do not match.
+ */
+int s21_solve(matrix_t *, matrix_t *, matrix_t *);
+
+/*
+ * A = L L^T for symmetric positive-definite A: result is the lower
+ * triangular L, found with half the work of LU and no pivoting from the
+ * lower triangle of a alone. CALCULATION_ERROR when a is not square or not
+ * positive definite. s21_cholesky_solve solves L L^T X = B given L and
+ * counts under S21_STATS_SOLVE.
+ *
+ * s21_determinant and s21_inverse_matrix(_into) try this first for exactly
+ * symmetric matrices from 32 rows up and fall back to LU when the
+ * factorisation fails; s21_set_spd_detection(FALSE) or S21_MATRIX_SPD=0
+ * skips the attempt.
+ */
+int s21_cholesky(matrix_t *, matrix_t *);
+int s21_cholesky_solve(matrix_t *, matrix_t *, matrix_t *);
+void s21_set_spd_detection(int);
+int s21_spd_detection(void);
+
+/*
+ * Thread-local bump allocator. Everything allocated after s21_arena_begin
+ * is released at once by the matching s21_arena_end; arena matrices may be
+ * passed to s21_remove_matrix on any thread, which leaves them to the arena
+ * of the thread that allocated them.
+ */
+s21_arena_mark_t s21_arena_begin(void);
+void s21_arena_end(s21_arena_mark_t);
+void *s21_arena_alloc(size_t);
+int s21_arena_create_matrix(int, int, matrix_t *);
+void s21_arena_release(void);
+size_t s21_arena_chunks_allocated(void);
+
+/*
+ * count same-shaped products in one call, interleaved so that SIMD lanes
+ * span matrices; result l may alias only a[l] or b[l] and is reused when
+ * it already has the right shape
+ */
+int s21_mult_matrix_batched(matrix_t *, matrix_t *, matrix_t *, int);
+/* m x k by k x n row-major products, matrix l at a + l * stride_a */
+int s21_mult_matrix_strided(int m, int k, int n, const double *a,
+                            int stride_a, const double *b, int stride_b,
+                            double *c, int stride_c, int count);
+
+/*
+ * Per-matrix determinants and inverses of count same-sized square matrices.
+ * singular (optional) gets TRUE for each matrix with a zero pivot, whose
+ * determinant is reported as 0 and whose inverse is left zero filled.
+ */
+int s21_determinant_batched(matrix_t *, double *, int *singular, int count);
+int s21_inverse_batched(matrix_t *, matrix_t *, int *singular, int count);
+
+/*
+ * Deferred element-wise chains over same-shaped matrices. add, sub and
+ * scale take ownership of their operands and return the combined chain, so
+ * a whole chain is built in one expression and released by one
+ * s21_expr_free; a NULL operand (failed allocation) yields NULL. Matrices
+ * are read only by s21_expr_eval, which computes the chain in one pass into
+ * a result reused as by the _into functions. The result may alias any
+ * operand, and the chain can be evaluated again.
+ */
+typedef struct s21_expr s21_expr_t;
+s21_expr_t *s21_expr_matrix(matrix_t *);
+s21_expr_t *s21_expr_add(s21_expr_t *, s21_expr_t *);
+s21_expr_t *s21_expr_sub(s21_expr_t *, s21_expr_t *);
+s21_expr_t *s21_expr_scale(s21_expr_t *, double);
+int s21_expr_eval(s21_expr_t *, matrix_t *);
+void s21_expr_free(s21_expr_t *);
+
+/*
+ * Binary matrix files: a 64-byte header with magic, version, dtype, layout,
+ * rows, columns, leading dimension, data offset and checksums, followed by
+ * the rows padded to a multiple of 8 doubles. s21_matrix_save writes
+ * a temporary file and renames it over path, so readers never see a partial
+ * file. s21_matrix_mmap maps the file read-only and shared, checks only the
+ * header and builds the row table, so loading does not touch the data. The
+ * mapped matrix is an operand only: writing to it faults, the _into
+ * functions reject it as a result with ERROR, and s21_remove_matrix unmaps
+ * it. s21_matrix_verify reads the data back
+ * against its checksum and returns CALCULATION_ERROR when it differs.
+ */
+int s21_matrix_save(matrix_t *, const char *);
+int s21_matrix_mmap(const char *, matrix_t *);
+int s21_matrix_verify(const char *);
+
+/*
+ * Product of two matrix files into a third without loading them: square
+ * tiles are copied out of the mappings and multiplied by the in-core kernel
+ * while a helper thread reads the next tiles and writes finished result
+ * tiles. The six tile buffers fit in memory_budget bytes, and ERROR means
+ * it does not hold even 8x8 tiles.
+ */
+int s21_mult_matrix_file(const char *, const char *, const char *,
+                         size_t memory_budget);
+
+/*
+ * Compressed sparse rows (CSR) or columns (CSC): the nonzeros of row
+ * (column) l are values[ptr[l]..ptr[l + 1]), at the columns (rows) given by
+ * index in ascending order. The arrays share one block from
+ * s21_sparse_create, sized by nnz rather than rows * columns. Results are
+ * created like those of the dense functions; sparse results may also
+ * replace an operand, which is then freed.
+ */
+#define S21_SPARSE_CSR 0
+#define S21_SPARSE_CSC 1
+
+typedef struct {
+  int format;
+  int rows;
+  int columns;
+  size_t nnz;
+  size_t *ptr;
+  int *index;
+  double *values;
+} s21_sparse_t;
+
+int s21_sparse_create(int rows, int columns, size_t nnz, int format,
+                      s21_sparse_t *);
+void s21_sparse_free(s21_sparse_t *);
+int s21_sparse_from_matrix(matrix_t *, int format, s21_sparse_t *);
+int s21_sparse_to_matrix(s21_sparse_t *, matrix_t *);
+int s21_sparse_convert(s21_sparse_t *, int format, s21_sparse_t *);
+/* y = a * x for x of a.columns and y of a.rows elements, not overlapping */
+int s21_sparse_mult_vector(s21_sparse_t *, const double *x, double *y);
+/*
+ * sparse by dense; a CSC operand is converted to CSR first. The result is
+ * created before b is read, so it must not be b.
+ */
+int s21_sparse_mult_matrix(s21_sparse_t *, matrix_t *, matrix_t *);
+/* the union of both patterns less exact cancellations, any format of b */
+int s21_sparse_sum(s21_sparse_t *, s21_sparse_t *, s21_sparse_t *);
+int s21_sparse_mult_number(s21_sparse_t *, double, s21_sparse_t *);
+
+/* 0 restores the default: S21_NUM_THREADS or the number of online CPUs */
+void s21_set_num_threads(int);
+int s21_get_num_threads(void);
+
+/* Strassen-Winograd for products whose sides all exceed the cutoff, 128
+ * unless S21_STRASSEN_CUTOFF is set; 0 turns it off */
+void s21_set_strassen_cutoff(int);
+int s21_strassen_cutoff(void);
+
+/*
+ * ISA level of the element-wise kernels and of the GEMM behind products and
+ * factorisations; a level outside what the CPU supports selects the best.
+ * Safe while other threads compute: each kernel call uses one whole table.
+ */
+int s21_isa_level(void);
+int s21_set_isa_level(int);
+
+#define S21_STATS_CREATE_MATRIX 0
+#define S21_STATS_REMOVE_MATRIX 1
+#define S21_STATS_EQ_MATRIX 2
+#define S21_STATS_SUM_MATRIX 3
+#define S21_STATS_SUB_MATRIX 4
+#define S21_STATS_MULT_NUMBER 5
+#define S21_STATS_MULT_MATRIX 6
+#define S21_STATS_TRANSPOSE 7
+#define S21_STATS_CALC_COMPLEMENTS 8
+#define S21_STATS_DETERMINANT 9
+#define S21_STATS_INVERSE_MATRIX 10
+#define S21_STATS_LU_FACTOR 11
+#define S21_STATS_LU_SOLVE 12
+#define S21_STATS_MULT_MATRIX_BATCHED 13
+#define S21_STATS_DETERMINANT_BATCHED 14
+#define S21_STATS_INVERSE_BATCHED 15
+#define S21_STATS_EXPR_EVAL 16
+#define S21_STATS_SPARSE_MULT_VECTOR 17
+#define S21_STATS_SPARSE_MULT_MATRIX 18
+#define S21_STATS_CHOLESKY 19
+#define S21_STATS_SOLVE 20
+#define S21_STATS_COUNT 21
+
+typedef struct {
+  unsigned long long calls;
+  unsigned long long flops;
+  unsigned long long bytes_allocated;
+  unsigned long long temporaries;
+  unsigned long long nanoseconds;
+} s21_stats_t;
+
+/*
+ * Per-function counters, compiled in with -DS21_STATS (make STATS=1) and
+ * indexed by S21_STATS_*; _into and in-place variants count under the base
+ * function, and s21_cholesky_solve under S21_STATS_SOLVE. Only the
+ * outermost call on a thread is counted, and what it allocates there is
+ * charged to it. Each thread writes its own counters; a snapshot sums live
+ * and exited threads since the last reset, and is all zero in builds
+ * without S21_STATS.
+ */
+int s21_stats_enabled(void);
+int s21_stats_snapshot(s21_stats_t *);
+void s21_stats_reset(void);
+const char *s21_stats_name(int);
+
+#ifdef __GNUC__
+#pragma GCC visibility pop
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
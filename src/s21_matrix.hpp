@@ -0,0 +1,547 @@
+#ifndef S21_MATRIX_HPP
+#define S21_MATRIX_HPP
+
+#include <array>
+#include <cfloat>
+#include <cstring>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_matrix.h"
+
+namespace s21 {
+
+inline constexpr int kDynamic = -1;
+
+template <int R, int C>
+class Matrix;
+
+namespace detail {
+
+constexpr double Abs(double x) { return x < 0 ? -x : x; }
+
+/* std::swap is not constexpr before C++20 */
+constexpr void Swap(double &a, double &b) {
+  double t = a;
+  a = b;
+  b = t;
+}
+
+/* |a - b| < 1e-7, the same test as s21_eq_matrix */
+constexpr bool Near(double a, double b) { return Abs(a - b) < 1e-7; }
+
+template <int N>
+constexpr double MaxAbs(const Matrix<N, N> &a) {
+  double max = 0.0;
+  for (int i = 0; i < N; i++)
+    for (int j = 0; j < N; j++)
+      if (Abs(a(i, j)) > max) max = Abs(a(i, j));
+  return max;
+}
+
+/* pivots at or below N * DBL_EPSILON * max|a| count as zero, as in LU */
+template <int N>
+constexpr double Tolerance(const Matrix<N, N> &a) {
+  return N * DBL_EPSILON * MaxAbs(a);
+}
+
+/* Gaussian elimination with partial pivoting; with inv it runs on to
+ * Gauss-Jordan and leaves the inverse there. Returns false if singular. */
+template <int N>
+constexpr bool Eliminate(Matrix<N, N> a, double *det, Matrix<N, N> *inv) {
+  double tol = Tolerance(a), d = 1.0;
+  bool regular = true;
+  for (int c = 0; c < N && regular; c++) {
+    int p = c;
+    for (int i = c + 1; i < N; i++)
+      if (Abs(a(i, c)) > Abs(a(p, c))) p = i;
+    if (p != c) {
+      for (int j = 0; j < N; j++) {
+        Swap(a(c, j), a(p, j));
+        if (inv) Swap((*inv)(c, j), (*inv)(p, j));
+      }
+      d = -d;
+    }
+    regular = Abs(a(c, c)) > tol;
+    d *= a(c, c);
+    for (int i = inv ? 0 : c + 1; i < N && regular; i++) {
+      if (i == c) continue;
+      double f = a(i, c) / a(c, c);
+      for (int j = c; j < N; j++) a(i, j) -= f * a(c, j);
+      for (int j = 0; j < N && inv; j++) (*inv)(i, j) -= f * (*inv)(c, j);
+    }
+  }
+  for (int i = 0; i < N && inv && regular; i++)
+    for (int j = 0; j < N; j++) (*inv)(i, j) /= a(i, i);
+  if (det) *det = regular ? d : 0.0;
+  return regular;
+}
+
+}  // namespace detail
+
+/*
+ * R x C matrix stored inline, so small fixed shapes never touch the heap and
+ * every loop has constant bounds the compiler can unroll. The operations
+ * mirror the C API and are constexpr; a singular inverse throws
+ * std::domain_error like CALCULATION_ERROR would be returned.
+ */
+template <int R, int C>
+class Matrix {
+  static_assert(R > 0 && C > 0, "use Matrix<kDynamic, kDynamic>");
+
+ public:
+  constexpr Matrix() : data_{} {}
+
+  /* row-major values; missing ones stay zero */
+  constexpr Matrix(std::initializer_list<double> values) : data_{} {
+    int e = 0;
+    for (double v : values)
+      if (e < R * C) data_[e++] = v;
+  }
+
+  static constexpr Matrix Identity() {
+    static_assert(R == C, "identity needs a square matrix");
+    Matrix m;
+    for (int i = 0; i < R; i++) m(i, i) = 1.0;
+    return m;
+  }
+
+  constexpr int Rows() const { return R; }
+  constexpr int Cols() const { return C; }
+  constexpr double &operator()(int i, int j) { return data_[i * C + j]; }
+  constexpr const double &operator()(int i, int j) const {
+    return data_[i * C + j];
+  }
+  constexpr double *Data() { return data_.data(); }
+  constexpr const double *Data() const { return data_.data(); }
+
+  constexpr bool EqMatrix(const Matrix &b) const {
+    bool eq = true;
+    for (int e = 0; e < R * C && eq; e++)
+      eq = detail::Near(data_[e], b.data_[e]);
+    return eq;
+  }
+  constexpr bool operator==(const Matrix &b) const { return EqMatrix(b); }
+  constexpr bool operator!=(const Matrix &b) const { return !EqMatrix(b); }
+
+  constexpr Matrix &operator+=(const Matrix &b) {
+    for (int e = 0; e < R * C; e++) data_[e] += b.data_[e];
+    return *this;
+  }
+  constexpr Matrix &operator-=(const Matrix &b) {
+    for (int e = 0; e < R * C; e++) data_[e] -= b.data_[e];
+    return *this;
+  }
+  constexpr Matrix &operator*=(double k) {
+    for (int e = 0; e < R * C; e++) data_[e] *= k;
+    return *this;
+  }
+  constexpr Matrix &operator*=(const Matrix<C, C> &b) {
+    return *this = *this * b;
+  }
+
+  constexpr Matrix operator+(const Matrix &b) const {
+    return Matrix(*this) += b;
+  }
+  constexpr Matrix operator-(const Matrix &b) const {
+    return Matrix(*this) -= b;
+  }
+  constexpr Matrix operator*(double k) const { return Matrix(*this) *= k; }
+  friend constexpr Matrix operator*(double k, const Matrix &a) { return a * k; }
+
+  template <int K>
+  constexpr Matrix<R, K> operator*(const Matrix<C, K> &b) const {
+    Matrix<R, K> c;
+    for (int i = 0; i < R; i++)
+      for (int p = 0; p < C; p++)
+        for (int j = 0; j < K; j++) c(i, j) += (*this)(i, p) * b(p, j);
+    return c;
+  }
+
+  constexpr Matrix<C, R> Transpose() const {
+    Matrix<C, R> t;
+    for (int i = 0; i < R; i++)
+      for (int j = 0; j < C; j++) t(j, i) = (*this)(i, j);
+    return t;
+  }
+
+  /* the matrix without row r and column c */
+  constexpr Matrix<R - 1, C - 1> Minor(int r, int c) const {
+    Matrix<R - 1, C - 1> m;
+    for (int i = 0, mi = 0; i < R; i++) {
+      for (int j = 0, mj = 0; j < C && i != r; j++)
+        if (j != c) m(mi, mj++) = (*this)(i, j);
+      if (i != r) mi++;
+    }
+    return m;
+  }
+
+  /* closed forms up to 4x4, partial pivoting elimination above */
+  constexpr double Determinant() const {
+    static_assert(R == C, "determinant needs a square matrix");
+    const Matrix &a = *this;
+    double det = 0.0;
+    if constexpr (R == 1) {
+      det = a(0, 0);
+    } else if constexpr (R == 2) {
+      det = a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+    } else if constexpr (R == 3) {
+      det = a(0, 0) * (a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1)) -
+            a(0, 1) * (a(1, 0) * a(2, 2) - a(1, 2) * a(2, 0)) +
+            a(0, 2) * (a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0));
+    } else if constexpr (R == 4) {
+      double s0 = a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+      double s1 = a(0, 0) * a(1, 2) - a(1, 0) * a(0, 2);
+      double s2 = a(0, 0) * a(1, 3) - a(1, 0) * a(0, 3);
+      double s3 = a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2);
+      double s4 = a(0, 1) * a(1, 3) - a(1, 1) * a(0, 3);
+      double s5 = a(0, 2) * a(1, 3) - a(1, 2) * a(0, 3);
+      double c5 = a(2, 2) * a(3, 3) - a(3, 2) * a(2, 3);
+      double c4 = a(2, 1) * a(3, 3) - a(3, 1) * a(2, 3);
+      double c3 = a(2, 1) * a(3, 2) - a(3, 1) * a(2, 2);
+      double c2 = a(2, 0) * a(3, 3) - a(3, 0) * a(2, 3);
+      double c1 = a(2, 0) * a(3, 2) - a(3, 0) * a(2, 2);
+      double c0 = a(2, 0) * a(3, 1) - a(3, 0) * a(2, 1);
+      det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    } else {
+      detail::Eliminate<R>(a, &det, nullptr);
+    }
+    return det;
+  }
+
+  constexpr Matrix CalcComplements() const {
+    static_assert(R == C, "complements need a square matrix");
+    Matrix m;
+    if constexpr (R == 1) {
+      m(0, 0) = 1.0;
+    } else {
+      for (int i = 0; i < R; i++)
+        for (int j = 0; j < C; j++)
+          m(i, j) = ((i + j) % 2 ? -1.0 : 1.0) * Minor(i, j).Determinant();
+    }
+    return m;
+  }
+
+  /* the adjugate up to 4x4, Gauss-Jordan above */
+  constexpr Matrix Inverse() const {
+    static_assert(R == C, "inverse needs a square matrix");
+    Matrix inv = Identity();
+    bool regular = true;
+    if constexpr (R <= 4) {
+      double det = Determinant(), max = detail::MaxAbs(*this), bound = R;
+      for (int i = 0; i < R; i++) bound *= max;
+      regular = detail::Abs(det) > bound * DBL_EPSILON;
+      if (regular) inv = CalcComplements().Transpose() * (1.0 / det);
+    } else {
+      regular = detail::Eliminate<R>(*this, nullptr, &inv);
+    }
+    if (!regular) throw std::domain_error("s21::Matrix: singular matrix");
+    return inv;
+  }
+
+ private:
+  std::array<double, R * C> data_;
+};
+
+template <>
+class Matrix<kDynamic, kDynamic>;
+
+using DynMatrix = Matrix<kDynamic, kDynamic>;
+
+/*
+ * Element-wise expressions over run-time sized matrices. The operators only
+ * record what to compute; assigning the expression to a DynMatrix evaluates
+ * it row by row in one pass, with no intermediate matrices. DynMatrix
+ * operands are held by reference, so an expression is meant to be assigned
+ * within the statement that builds it.
+ */
+template <class E>
+struct Expr {
+  const E &Self() const { return static_cast<const E &>(*this); }
+};
+
+namespace detail {
+
+template <class E>
+struct Operand {
+  using type = E;
+};
+
+template <>
+struct Operand<DynMatrix> {
+  using type = const DynMatrix &;
+};
+
+struct Plus {
+  static double Apply(double a, double b) { return a + b; }
+};
+
+struct Minus {
+  static double Apply(double a, double b) { return a - b; }
+};
+
+template <class L, class R, class Op>
+struct BinaryRow {
+  L l;
+  R r;
+  double operator[](int j) const { return Op::Apply(l[j], r[j]); }
+};
+
+template <class E>
+struct ScaledRow {
+  E e;
+  double k;
+  double operator[](int j) const { return e[j] * k; }
+};
+
+/* ERROR, CALCULATION_ERROR and a failed allocation as exceptions */
+inline void Check(int code) {
+  if (code == ERROR) throw std::invalid_argument("s21::Matrix: bad operand");
+  if (code == CALCULATION_ERROR)
+    throw std::domain_error("s21::Matrix: calculation error");
+}
+
+/* the C API takes non-const pointers but leaves its inputs alone */
+inline matrix_t *In(const matrix_t *m) { return const_cast<matrix_t *>(m); }
+
+}  // namespace detail
+
+/* a borrowed read-only matrix_t, usable wherever a DynMatrix operand is */
+class MatrixRef : public Expr<MatrixRef> {
+ public:
+  explicit MatrixRef(const matrix_t &m) : m_(&m) {}
+
+  int Rows() const { return m_->rows; }
+  int Cols() const { return m_->columns; }
+  const double *Row(int i) const { return m_->matrix[i]; }
+  const matrix_t *Get() const { return m_; }
+
+ private:
+  const matrix_t *m_;
+};
+
+template <class L, class R, class Op>
+class Binary : public Expr<Binary<L, R, Op>> {
+ public:
+  Binary(const L &l, const R &r) : l_(l), r_(r) {
+    if (l.Rows() != r.Rows() || l.Cols() != r.Cols())
+      detail::Check(CALCULATION_ERROR);
+  }
+
+  int Rows() const { return l_.Rows(); }
+  int Cols() const { return l_.Cols(); }
+  auto Row(int i) const {
+    using Row = detail::BinaryRow<decltype(l_.Row(i)), decltype(r_.Row(i)), Op>;
+    return Row{l_.Row(i), r_.Row(i)};
+  }
+
+ private:
+  typename detail::Operand<L>::type l_;
+  typename detail::Operand<R>::type r_;
+};
+
+template <class E>
+class Scaled : public Expr<Scaled<E>> {
+ public:
+  Scaled(const E &e, double k) : e_(e), k_(k) {}
+
+  int Rows() const { return e_.Rows(); }
+  int Cols() const { return e_.Cols(); }
+  auto Row(int i) const {
+    return detail::ScaledRow<decltype(e_.Row(i))>{e_.Row(i), k_};
+  }
+
+ private:
+  typename detail::Operand<E>::type e_;
+  double k_;
+};
+
+/*
+ * Sizes known only at run time own a matrix_t and go through the C API.
+ * ERROR from it surfaces as std::invalid_argument, CALCULATION_ERROR as
+ * std::domain_error and a failed allocation as std::bad_alloc. Copies are
+ * made only through Clone; moves just hand the matrix_t over.
+ */
+template <>
+class Matrix<kDynamic, kDynamic> : public Expr<DynMatrix> {
+ public:
+  Matrix() = default;
+
+  Matrix(int rows, int cols) {
+    if (rows < 1 || cols < 1)
+      throw std::invalid_argument("s21::Matrix: bad dimensions");
+    if (s21_create_matrix(rows, cols, &m_) != OK) throw std::bad_alloc();
+  }
+
+  template <int R, int C>
+  explicit Matrix(const Matrix<R, C> &a) : Matrix(R, C) {
+    for (int i = 0; i < R; i++)
+      std::memcpy(m_.matrix[i], a.Data() + i * C, sizeof(double) * C);
+  }
+
+  template <class E>
+  Matrix(const Expr<E> &e) : Matrix(e.Self().Rows(), e.Self().Cols()) {
+    Assign(e.Self());
+  }
+
+  Matrix(const Matrix &) = delete;
+  Matrix &operator=(const Matrix &) = delete;
+
+  Matrix(Matrix &&a) noexcept : m_(a.m_) { a.m_ = matrix_t{}; }
+
+  Matrix &operator=(Matrix &&a) noexcept {
+    std::swap(m_, a.m_);
+    return *this;
+  }
+
+  /* storage is reused when the shape already matches */
+  template <class E>
+  Matrix &operator=(const Expr<E> &e) {
+    if (e.Self().Rows() == Rows() && e.Self().Cols() == Cols())
+      Assign(e.Self());
+    else
+      *this = Matrix(e);
+    return *this;
+  }
+
+  ~Matrix() { s21_remove_matrix(&m_); }
+
+  /* takes over a matrix created by the C API */
+  static Matrix Adopt(matrix_t m) {
+    Matrix a;
+    a.m_ = m;
+    return a;
+  }
+
+  /* hands the matrix back to the caller, who must remove it */
+  matrix_t Release() {
+    matrix_t m = m_;
+    m_ = matrix_t{};
+    return m;
+  }
+
+  Matrix Clone() const { return m_.matrix ? Matrix(MatrixRef(m_)) : Matrix(); }
+
+  int Rows() const { return m_.rows; }
+  int Cols() const { return m_.columns; }
+  double &operator()(int i, int j) { return m_.matrix[i][j]; }
+  const double &operator()(int i, int j) const { return m_.matrix[i][j]; }
+  const double *Row(int i) const { return m_.matrix[i]; }
+
+  /* for passing to the C API; the matrix keeps ownership */
+  matrix_t *Get() { return &m_; }
+  const matrix_t *Get() const { return &m_; }
+
+  bool EqMatrix(const Matrix &b) const {
+    return s21_eq_matrix(detail::In(&m_), detail::In(&b.m_)) == TRUE;
+  }
+  bool operator==(const Matrix &b) const { return EqMatrix(b); }
+  bool operator!=(const Matrix &b) const { return !EqMatrix(b); }
+
+  template <class E>
+  Matrix &operator+=(const Expr<E> &e) {
+    return *this = *this + e;
+  }
+  template <class E>
+  Matrix &operator-=(const Expr<E> &e) {
+    return *this = *this - e;
+  }
+  template <class E>
+  Matrix &operator*=(const Expr<E> &e) {
+    return *this = *this * e;
+  }
+  Matrix &operator*=(double k);
+
+  Matrix Transpose() const { return Apply(s21_transpose_into); }
+  Matrix CalcComplements() const { return Apply(s21_calc_complements_into); }
+  Matrix Inverse() const { return Apply(s21_inverse_matrix_into); }
+
+  double Determinant() const {
+    double det = 0.0;
+    detail::Check(s21_determinant(detail::In(&m_), &det));
+    return det;
+  }
+
+ private:
+  template <class E>
+  void Assign(const E &e) {
+    for (int i = 0; i < Rows(); i++) {
+      auto row = e.Row(i);
+      double *out = m_.matrix[i];
+      for (int j = 0; j < Cols(); j++) out[j] = row[j];
+    }
+  }
+
+  Matrix Apply(int (*op)(matrix_t *, matrix_t *)) const {
+    Matrix r;
+    detail::Check(op(detail::In(&m_), &r.m_));
+    return r;
+  }
+
+  matrix_t m_{};
+};
+
+template <class L, class R>
+Binary<L, R, detail::Plus> operator+(const Expr<L> &l, const Expr<R> &r) {
+  return {l.Self(), r.Self()};
+}
+
+template <class L, class R>
+Binary<L, R, detail::Minus> operator-(const Expr<L> &l, const Expr<R> &r) {
+  return {l.Self(), r.Self()};
+}
+
+template <class E>
+Scaled<E> operator*(const Expr<E> &e, double k) {
+  return {e.Self(), k};
+}
+
+template <class E>
+Scaled<E> operator*(double k, const Expr<E> &e) {
+  return {e.Self(), k};
+}
+
+template <class E>
+Scaled<E> operator/(const Expr<E> &e, double k) {
+  return {e.Self(), 1.0 / k};
+}
+
+template <class E>
+Scaled<E> operator-(const Expr<E> &e) {
+  return {e.Self(), -1.0};
+}
+
+inline DynMatrix &DynMatrix::operator*=(double k) { return *this = *this * k; }
+
+namespace detail {
+
+inline const DynMatrix &Materialize(const DynMatrix &m) { return m; }
+inline const MatrixRef &Materialize(const MatrixRef &m) { return m; }
+
+template <class E>
+DynMatrix Materialize(const Expr<E> &e) {
+  return DynMatrix(e);
+}
+
+}  // namespace detail
+
+/* a product is not element-wise, so expression operands are evaluated */
+template <class L, class R>
+DynMatrix operator*(const Expr<L> &l, const Expr<R> &r) {
+  const auto &a = detail::Materialize(l.Self());
+  const auto &b = detail::Materialize(r.Self());
+  DynMatrix c;
+  detail::Check(s21_mult_matrix_into(detail::In(a.Get()), detail::In(b.Get()),
+                                     c.Get()));
+  return c;
+}
+
+using Matrix2d = Matrix<2, 2>;
+using Matrix3d = Matrix<3, 3>;
+using Matrix4d = Matrix<4, 4>;
+
+}  // namespace s21
+
+#endif
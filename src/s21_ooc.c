@@ -0,0 +1,172 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "s21_internal.h"
+
+/* front and back tiles of a and b, the result tile and the one being stored */
+#define S21_OOC_BUFFERS 6
+#define S21_OOC_MIN_TILE 8
+
+/* the work of the I/O thread for one step */
+typedef struct {
+  matrix_t *a, *b;
+  int fd, columns;
+  /* a[i0.., p0..) and b[p0.., j0..) into load_a and load_b */
+  matrix_t *load_a, *load_b;
+  int i0, j0, p0, mt, nt, kt;
+  /* store_c to result[ci.., cj..) */
+  matrix_t *store_c;
+  int ci, cj, cm, cn;
+  int status;
+} s21_ooc_io_t;
+
+typedef struct {
+  int tile, tiles_j, tiles_k;
+  int m, n, k;
+} s21_ooc_plan_t;
+
+/* the largest multiple of 8 whose buffers fit, no larger than needed */
+static int s21_ooc_tile(size_t budget, int m, int n, int k) {
+  int most = m > n ? m : n;
+  if (k > most) most = k;
+  most = (most + S21_OOC_MIN_TILE - 1) / S21_OOC_MIN_TILE * S21_OOC_MIN_TILE;
+  double fit = sqrt((double)budget / S21_OOC_BUFFERS / sizeof(double));
+  int t = fit < most ? (int)fit / S21_OOC_MIN_TILE * S21_OOC_MIN_TILE : most;
+  while (t >= S21_OOC_MIN_TILE &&
+         S21_OOC_BUFFERS * s21_block_bytes(t, t) > budget)
+    t -= S21_OOC_MIN_TILE;
+  return t < S21_OOC_MIN_TILE ? 0 : t;
+}
+
+static void *s21_ooc_io(void *ctx) {
+  s21_ooc_io_t *io = ctx;
+  for (int r = 0; io->store_c && r < io->cm && io->status == OK; r++) {
+    size_t bytes = sizeof(double) * io->cn;
+    if (pwrite(io->fd, io->store_c->matrix[r], bytes,
+               s21_file_offset(io->columns, io->ci + r, io->cj)) !=
+        (ssize_t)bytes)
+      io->status = ERROR;
+  }
+  for (int r = 0; io->load_a && r < io->mt; r++) {
+    memcpy(io->load_a->matrix[r], io->a->matrix[io->i0 + r] + io->p0,
+           sizeof(double) * io->kt);
+  }
+  for (int r = 0; io->load_b && r < io->kt; r++) {
+    memcpy(io->load_b->matrix[r], io->b->matrix[io->p0 + r] + io->j0,
+           sizeof(double) * io->nt);
+  }
+  return NULL;
+}
+
+/* step s is the product of tiles (i, p) and (p, j), p varying fastest */
+static void s21_ooc_step(const s21_ooc_plan_t *plan, long s, int *i, int *j,
+                         int *p) {
+  *p = s % plan->tiles_k * plan->tile;
+  *j = s / plan->tiles_k % plan->tiles_j * plan->tile;
+  *i = s / plan->tiles_k / plan->tiles_j * plan->tile;
+}
+
+static int s21_ooc_extent(int total, int start, int tile) {
+  return total - start < tile ? total - start : tile;
+}
+
+static void s21_ooc_load(s21_ooc_io_t *io, const s21_ooc_plan_t *plan,
+                         long s, matrix_t *a, matrix_t *b) {
+  s21_ooc_step(plan, s, &io->i0, &io->j0, &io->p0);
+  io->mt = s21_ooc_extent(plan->m, io->i0, plan->tile);
+  io->nt = s21_ooc_extent(plan->n, io->j0, plan->tile);
+  io->kt = s21_ooc_extent(plan->k, io->p0, plan->tile);
+  io->load_a = a;
+  io->load_b = b;
+}
+
+static void s21_swap_tiles(matrix_t **x, matrix_t **y) {
+  matrix_t *t = *x;
+  *x = *y;
+  *y = t;
+}
+
+/*
+ * While step s multiplies the front tiles, the I/O thread reads the tiles
+ * of step s + 1 into the back ones and stores the last finished result
+ * tile. Without a thread the I/O simply runs before the product.
+ */
+static int s21_ooc_run(s21_ooc_io_t *base, const s21_ooc_plan_t *plan,
+                       matrix_t *buf) {
+  matrix_t *fa = &buf[0], *fb = &buf[1], *ba = &buf[2], *bb = &buf[3];
+  matrix_t *c = &buf[4], *done = &buf[5];
+  long steps =
+      (long)(plan->m + plan->tile - 1) / plan->tile * plan->tiles_j *
+      plan->tiles_k;
+  s21_ooc_io_t io = *base, pending = *base;
+  s21_ooc_load(&io, plan, 0, fa, fb);
+  s21_ooc_io(&io);
+  int ret = io.status;
+  for (long s = 0; s < steps && ret == OK; s++) {
+    s21_ooc_io_t front = io;
+    io = pending;
+    pending.store_c = NULL;
+    if (s + 1 < steps) s21_ooc_load(&io, plan, s + 1, ba, bb);
+    pthread_t thread;
+    int threaded = pthread_create(&thread, NULL, s21_ooc_io, &io) == 0;
+    if (!threaded) s21_ooc_io(&io);
+    if (front.p0 == 0) {
+      for (int r = 0; r < front.mt; r++)
+        memset(c->matrix[r], 0, sizeof(double) * front.nt);
+    }
+    s21_gemm(front.mt, front.nt, front.kt, 1.0, fa->matrix, fb->matrix,
+             c->matrix);
+    if (threaded) pthread_join(thread, NULL);
+    ret = io.status;
+    s21_swap_tiles(&fa, &ba);
+    s21_swap_tiles(&fb, &bb);
+    if (front.p0 + front.kt == plan->k) {
+      s21_swap_tiles(&c, &done);
+      pending = *base;
+      pending.store_c = done;
+      pending.ci = front.i0;
+      pending.cj = front.j0;
+      pending.cm = front.mt;
+      pending.cn = front.nt;
+    }
+  }
+  if (ret == OK) {
+    s21_ooc_io(&pending);
+    ret = pending.status;
+  }
+  return ret;
+}
+
+int s21_mult_matrix_file(const char *a_path, const char *b_path,
+                         const char *result_path, size_t memory_budget) {
+  matrix_t a = {0}, b = {0}, buf[S21_OOC_BUFFERS] = {{0}};
+  int ret = s21_matrix_mmap(a_path, &a);
+  if (ret == OK) ret = s21_matrix_mmap(b_path, &b);
+  if (ret == OK && a.columns != b.rows) ret = CALCULATION_ERROR;
+  int tile = ret == OK ? s21_ooc_tile(memory_budget, a.rows, b.columns,
+                                      a.columns)
+                       : 0;
+  if (ret == OK && !tile) ret = ERROR;
+  for (int i = 0; i < S21_OOC_BUFFERS && ret == OK; i++)
+    ret = s21_create_matrix(tile, tile, &buf[i]);
+  int fd = ret == OK && result_path
+               ? s21_file_create(result_path, a.rows, b.columns)
+               : -1;
+  if (ret == OK && fd < 0) ret = ERROR;
+  if (ret == OK) {
+    s21_ooc_plan_t plan = {tile, (b.columns + tile - 1) / tile,
+                           (a.columns + tile - 1) / tile, a.rows,
+                           b.columns, a.columns};
+    s21_ooc_io_t io = {.a = &a, .b = &b, .fd = fd, .columns = b.columns};
+    ret = s21_ooc_run(&io, &plan, buf);
+  }
+  if (fd >= 0) ret = s21_file_finish(fd, result_path, a.rows, b.columns, ret);
+  for (int i = 0; i < S21_OOC_BUFFERS; i++) s21_remove_matrix(&buf[i]);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  return ret;
+}
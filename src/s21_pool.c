@@ -0,0 +1,186 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "s21_internal.h"
+
+#define S21_MAX_THREADS 256
+
+/* tasks[top..bottom) of the shared task array; owner pops the bottom */
+typedef struct {
+  pthread_mutex_t lock;
+  int top;
+  int bottom;
+} s21_deque_t;
+
+static struct {
+  pthread_mutex_t job_lock;
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  pthread_cond_t done;
+  pthread_t threads[S21_MAX_THREADS];
+  s21_deque_t deques[S21_MAX_THREADS];
+  int seen[S21_MAX_THREADS];
+  int started;
+  int requested;
+  int fallback;
+  int generation;
+  int busy;
+  int shutdown;
+  int *tasks;
+  void (*fn)(void *, int);
+  void *ctx;
+} s21_pool = {.job_lock = PTHREAD_MUTEX_INITIALIZER,
+              .lock = PTHREAD_MUTEX_INITIALIZER,
+              .wake = PTHREAD_COND_INITIALIZER,
+              .done = PTHREAD_COND_INITIALIZER};
+
+static _Thread_local int s21_in_pool;
+static pthread_once_t s21_pool_once = PTHREAD_ONCE_INIT;
+
+
+static int s21_pop_bottom(s21_deque_t *d, int *task) {
+  int ret = FALSE;
+  pthread_mutex_lock(&d->lock);
+  if (d->top < d->bottom) {
+    *task = s21_pool.tasks[--d->bottom];
+    ret = TRUE;
+  }
+  pthread_mutex_unlock(&d->lock);
+  return ret;
+}
+
+static int s21_steal_top(s21_deque_t *d, int *task) {
+  int ret = FALSE;
+  pthread_mutex_lock(&d->lock);
+  if (d->top < d->bottom) {
+    *task = s21_pool.tasks[d->top++];
+    ret = TRUE;
+  }
+  pthread_mutex_unlock(&d->lock);
+  return ret;
+}
+
+/* jobs never spawn tasks, so one empty sweep means the job is drained */
+static void s21_pool_work(int self, int workers) {
+  int task = 0, found = TRUE;
+  while (found) {
+    found = s21_pop_bottom(&s21_pool.deques[self], &task);
+    for (int i = 1; i < workers && !found; i++) {
+      found = s21_steal_top(&s21_pool.deques[(self + i) % workers], &task);
+    }
+    if (found) s21_pool.fn(s21_pool.ctx, task);
+  }
+}
+
+static void *s21_pool_main(void *arg) {
+  int self = (int)(size_t)arg, seen = s21_pool.seen[self];
+  s21_in_pool = TRUE;
+  pthread_mutex_lock(&s21_pool.lock);
+  while (!s21_pool.shutdown) {
+    if (s21_pool.generation != seen) {
+      seen = s21_pool.generation;
+      int workers = s21_pool.started + 1;
+      pthread_mutex_unlock(&s21_pool.lock);
+      s21_pool_work(self, workers);
+      pthread_mutex_lock(&s21_pool.lock);
+      if (--s21_pool.busy == 0) pthread_cond_signal(&s21_pool.done);
+    } else {
+      pthread_cond_wait(&s21_pool.wake, &s21_pool.lock);
+    }
+  }
+  pthread_mutex_unlock(&s21_pool.lock);
+  return NULL;
+}
+
+static void s21_pool_stop(void) {
+  pthread_mutex_lock(&s21_pool.lock);
+  s21_pool.shutdown = TRUE;
+  pthread_cond_broadcast(&s21_pool.wake);
+  pthread_mutex_unlock(&s21_pool.lock);
+  for (int i = 1; i <= s21_pool.started; i++) {
+    pthread_join(s21_pool.threads[i], NULL);
+  }
+  s21_pool.started = 0;
+  s21_pool.shutdown = FALSE;
+}
+
+static int s21_default_threads(void) {
+  const char *env = getenv("S21_NUM_THREADS");
+  long n = env ? strtol(env, NULL, 10) : 0;
+  if (n <= 0) n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n < 1 ? 1 : n > S21_MAX_THREADS ? S21_MAX_THREADS : (int)n;
+}
+
+/* sysconf reads /sys on Linux, far too slow for every small product */
+static void s21_pool_init(void) {
+  for (int i = 0; i < S21_MAX_THREADS; i++) {
+    pthread_mutex_init(&s21_pool.deques[i].lock, NULL);
+  }
+  s21_pool.fallback = s21_default_threads();
+}
+
+int s21_get_num_threads(void) {
+  pthread_once(&s21_pool_once, s21_pool_init);
+  return s21_pool.requested ? s21_pool.requested : s21_pool.fallback;
+}
+
+void s21_set_num_threads(int n) {
+  pthread_mutex_lock(&s21_pool.job_lock);
+  if (n > S21_MAX_THREADS) n = S21_MAX_THREADS;
+  s21_pool.requested = n > 0 ? n : 0;
+  if (s21_pool.started + 1 != s21_get_num_threads()) s21_pool_stop();
+  pthread_mutex_unlock(&s21_pool.job_lock);
+}
+
+/* caller holds job_lock; workers are spawned on first use */
+static int s21_pool_start(void) {
+  int want = s21_get_num_threads() - 1;
+  for (int i = s21_pool.started + 1; i <= want; i++) {
+    s21_pool.seen[i] = s21_pool.generation;
+    if (pthread_create(&s21_pool.threads[i], NULL, s21_pool_main,
+                       (void *)(size_t)i) != 0)
+      break;
+    s21_pool.started = i;
+  }
+  return s21_pool.started + 1;
+}
+
+void s21_parallel_for(int count, void (*fn)(void *, int), void *ctx) {
+  int *tasks = NULL, workers = 1;
+  if (count > 1 && !s21_in_pool && s21_get_num_threads() > 1 &&
+      pthread_mutex_trylock(&s21_pool.job_lock) == 0) {
+    tasks = malloc(sizeof(int) * count);
+    if (tasks) workers = s21_pool_start();
+    if (workers == 1) pthread_mutex_unlock(&s21_pool.job_lock);
+  }
+  if (workers == 1) {
+    for (int i = 0; i < count; i++) fn(ctx, i);
+  } else {
+    for (int i = 0; i < count; i++) tasks[i] = i;
+    for (int w = 0; w < workers; w++) {
+      s21_pool.deques[w].top = (int)((long)count * w / workers);
+      s21_pool.deques[w].bottom = (int)((long)count * (w + 1) / workers);
+    }
+    pthread_mutex_lock(&s21_pool.lock);
+    s21_pool.tasks = tasks;
+    s21_pool.fn = fn;
+    s21_pool.ctx = ctx;
+    s21_pool.busy = workers - 1;
+    s21_pool.generation++;
+    pthread_cond_broadcast(&s21_pool.wake);
+    pthread_mutex_unlock(&s21_pool.lock);
+    s21_in_pool = TRUE;
+    s21_pool_work(0, workers);
+    s21_in_pool = FALSE;
+    pthread_mutex_lock(&s21_pool.lock);
+    while (s21_pool.busy > 0) {
+      pthread_cond_wait(&s21_pool.done, &s21_pool.lock);
+    }
+    pthread_mutex_unlock(&s21_pool.lock);
+    pthread_mutex_unlock(&s21_pool.job_lock);
+  }
+  free(tasks);
+}
@@ -0,0 +1,421 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "s21_internal.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define S21_X86 1
+#include <immintrin.h>
+#endif
+
+#define S21_EPS 1e-7
+
+static void s21_add_scalar(const double *a, const double *b, double *r,
+                           int n) {
+  for (int j = 0; j < n; j++) r[j] = a[j] + b[j];
+}
+
+static void s21_sub_scalar(const double *a, const double *b, double *r,
+                           int n) {
+  for (int j = 0; j < n; j++) r[j] = a[j] - b[j];
+}
+
+static void s21_scale_scalar(const double *a, double k, double *r, int n) {
+  for (int j = 0; j < n; j++) r[j] = a[j] * k;
+}
+
+static void s21_axpy_scalar(const double *a, double k, double *r, int n) {
+  for (int j = 0; j < n; j++) r[j] += a[j] * k;
+}
+
+static int s21_eq_scalar(const double *a, const double *b, int n) {
+  int ret = TRUE;
+  for (int j = 0; j < n && ret; j++) ret = s21_equal_double(a[j], b[j]);
+  return ret;
+}
+
+static void s21_transpose4_scalar(double *const *a, int aj, double *const *b,
+                                  int bj) {
+  for (int r = 0; r < 4; r++)
+    for (int c = 0; c < 4; c++) b[c][bj + r] = a[r][aj + c];
+}
+
+static void s21_stream_scalar(double *const *b, int bj, double *const *t,
+                              int m, int n) {
+  for (int c = 0; c < n; c++) memcpy(b[c] + bj, t[c], m * sizeof(double));
+}
+
+static void s21_mult_soa_scalar(int m, int n, int k, const double *a,
+                                const double *b, double *c) {
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      double acc[S21_BATCH_LANES] = {0};
+      for (int p = 0; p < k; p++) {
+        const double *ap = a + (i * k + p) * S21_BATCH_LANES;
+        const double *bp = b + (p * n + j) * S21_BATCH_LANES;
+        for (int l = 0; l < S21_BATCH_LANES; l++) acc[l] += ap[l] * bp[l];
+      }
+      memcpy(c + (i * n + j) * S21_BATCH_LANES, acc, sizeof(acc));
+    }
+  }
+}
+
+static double s21_gather_dot_scalar(const double *v, const int *index,
+                                    const double *x, int n) {
+  double sum = 0.0;
+  for (int p = 0; p < n; p++) sum += v[p] * x[index[p]];
+  return sum;
+}
+
+static const s21_kernels_t s21_kernels_scalar = {
+    S21_ISA_SCALAR, s21_add_scalar, s21_sub_scalar, s21_scale_scalar,
+    s21_axpy_scalar, s21_eq_scalar, s21_transpose4_scalar, s21_stream_scalar,
+    s21_mult_soa_scalar, s21_gather_dot_scalar};
+
+#ifdef S21_X86
+
+__attribute__((target("sse2"))) static void s21_add_sse2(const double *a,
+                                                         const double *b,
+                                                         double *r, int n) {
+  int j = 0;
+  for (; j + 2 <= n; j += 2)
+    _mm_storeu_pd(r + j, _mm_add_pd(_mm_loadu_pd(a + j), _mm_loadu_pd(b + j)));
+  s21_add_scalar(a + j, b + j, r + j, n - j);
+}
+
+__attribute__((target("sse2"))) static void s21_sub_sse2(const double *a,
+                                                         const double *b,
+                                                         double *r, int n) {
+  int j = 0;
+  for (; j + 2 <= n; j += 2)
+    _mm_storeu_pd(r + j, _mm_sub_pd(_mm_loadu_pd(a + j), _mm_loadu_pd(b + j)));
+  s21_sub_scalar(a + j, b + j, r + j, n - j);
+}
+
+__attribute__((target("sse2"))) static void s21_scale_sse2(const double *a,
+                                                           double k,
+                                                           double *r, int n) {
+  __m128d vk = _mm_set1_pd(k);
+  int j = 0;
+  for (; j + 2 <= n; j += 2)
+    _mm_storeu_pd(r + j, _mm_mul_pd(_mm_loadu_pd(a + j), vk));
+  s21_scale_scalar(a + j, k, r + j, n - j);
+}
+
+__attribute__((target("sse2"))) static void s21_axpy_sse2(const double *a,
+                                                          double k, double *r,
+                                                          int n) {
+  __m128d vk = _mm_set1_pd(k);
+  int j = 0;
+  for (; j + 2 <= n; j += 2)
+    _mm_storeu_pd(r + j, _mm_add_pd(_mm_loadu_pd(r + j),
+                                    _mm_mul_pd(_mm_loadu_pd(a + j), vk)));
+  s21_axpy_scalar(a + j, k, r + j, n - j);
+}
+
+__attribute__((target("sse2"))) static int s21_eq_sse2(const double *a,
+                                                       const double *b,
+                                                       int n) {
+  __m128d hi = _mm_set1_pd(S21_EPS), lo = _mm_set1_pd(-S21_EPS);
+  int ret = TRUE, j = 0;
+  for (; j + 2 <= n && ret; j += 2) {
+    __m128d d = _mm_sub_pd(_mm_loadu_pd(a + j), _mm_loadu_pd(b + j));
+    __m128d in = _mm_and_pd(_mm_cmplt_pd(d, hi), _mm_cmpgt_pd(d, lo));
+    ret = _mm_movemask_pd(in) == 0x3;
+  }
+  return ret && s21_eq_scalar(a + j, b + j, n - j);
+}
+
+__attribute__((target("sse2"))) static void s21_transpose4_sse2(
+    double *const *a, int aj, double *const *b, int bj) {
+  for (int r = 0; r < 4; r += 2) {
+    for (int c = 0; c < 4; c += 2) {
+      __m128d x = _mm_loadu_pd(a[r] + aj + c);
+      __m128d y = _mm_loadu_pd(a[r + 1] + aj + c);
+      _mm_storeu_pd(b[c] + bj + r, _mm_unpacklo_pd(x, y));
+      _mm_storeu_pd(b[c + 1] + bj + r, _mm_unpackhi_pd(x, y));
+    }
+  }
+}
+
+/* wider stores buy nothing once the write-combining buffers are full */
+__attribute__((target("sse2"))) static void s21_stream_sse2(double *const *b,
+                                                            int bj,
+                                                            double *const *t,
+                                                            int m, int n) {
+  for (int c = 0; c < n; c++) {
+    double *dst = b[c] + bj;
+    int r = 0;
+    if ((uintptr_t)dst % 16 == 0 && (uintptr_t)t[c] % 16 == 0) {
+      for (; r + 2 <= m; r += 2) _mm_stream_pd(dst + r, _mm_load_pd(t[c] + r));
+    }
+    for (; r < m; r++) dst[r] = t[c][r];
+  }
+  _mm_sfence();
+}
+
+__attribute__((target("sse2"))) static void s21_mult_soa_sse2(
+    int m, int n, int k, const double *a, const double *b, double *c) {
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      __m128d acc[S21_BATCH_LANES / 2];
+      for (int v = 0; v < S21_BATCH_LANES / 2; v++) acc[v] = _mm_setzero_pd();
+      for (int p = 0; p < k; p++) {
+        const double *ap = a + (i * k + p) * S21_BATCH_LANES;
+        const double *bp = b + (p * n + j) * S21_BATCH_LANES;
+        for (int v = 0; v < S21_BATCH_LANES / 2; v++)
+          acc[v] = _mm_add_pd(acc[v], _mm_mul_pd(_mm_loadu_pd(ap + 2 * v),
+                                                 _mm_loadu_pd(bp + 2 * v)));
+      }
+      for (int v = 0; v < S21_BATCH_LANES / 2; v++)
+        _mm_storeu_pd(c + (i * n + j) * S21_BATCH_LANES + 2 * v, acc[v]);
+    }
+  }
+}
+
+__attribute__((target("avx2"))) static void s21_add_avx2(const double *a,
+                                                         const double *b,
+                                                         double *r, int n) {
+  int j = 0;
+  for (; j + 4 <= n; j += 4)
+    _mm256_storeu_pd(r + j, _mm256_add_pd(_mm256_loadu_pd(a + j),
+                                          _mm256_loadu_pd(b + j)));
+  s21_add_sse2(a + j, b + j, r + j, n - j);
+}
+
+__attribute__((target("avx2"))) static void s21_sub_avx2(const double *a,
+                                                         const double *b,
+                                                         double *r, int n) {
+  int j = 0;
+  for (; j + 4 <= n; j += 4)
+    _mm256_storeu_pd(r + j, _mm256_sub_pd(_mm256_loadu_pd(a + j),
+                                          _mm256_loadu_pd(b + j)));
+  s21_sub_sse2(a + j, b + j, r + j, n - j);
+}
+
+__attribute__((target("avx2"))) static void s21_scale_avx2(const double *a,
+                                                           double k,
+                                                           double *r, int n) {
+  __m256d vk = _mm256_set1_pd(k);
+  int j = 0;
+  for (; j + 4 <= n; j += 4)
+    _mm256_storeu_pd(r + j, _mm256_mul_pd(_mm256_loadu_pd(a + j), vk));
+  s21_scale_sse2(a + j, k, r + j, n - j);
+}
+
+__attribute__((target("avx2"))) static void s21_axpy_avx2(const double *a,
+                                                          double k, double *r,
+                                                          int n) {
+  __m256d vk = _mm256_set1_pd(k);
+  int j = 0;
+  for (; j + 4 <= n; j += 4)
+    _mm256_storeu_pd(r + j,
+                     _mm256_add_pd(_mm256_loadu_pd(r + j),
+                                   _mm256_mul_pd(_mm256_loadu_pd(a + j), vk)));
+  s21_axpy_sse2(a + j, k, r + j, n - j);
+}
+
+__attribute__((target("avx2"))) static int s21_eq_avx2(const double *a,
+                                                       const double *b,
+                                                       int n) {
+  __m256d hi = _mm256_set1_pd(S21_EPS), lo = _mm256_set1_pd(-S21_EPS);
+  int ret = TRUE, j = 0;
+  for (; j + 4 <= n && ret; j += 4) {
+    __m256d d = _mm256_sub_pd(_mm256_loadu_pd(a + j), _mm256_loadu_pd(b + j));
+    __m256d in = _mm256_and_pd(_mm256_cmp_pd(d, hi, _CMP_LT_OQ),
+                               _mm256_cmp_pd(d, lo, _CMP_GT_OQ));
+    ret = _mm256_movemask_pd(in) == 0xf;
+  }
+  return ret && s21_eq_sse2(a + j, b + j, n - j);
+}
+
+__attribute__((target("avx2"))) static void s21_transpose4_avx2(
+    double *const *a, int aj, double *const *b, int bj) {
+  __m256d r0 = _mm256_loadu_pd(a[0] + aj), r1 = _mm256_loadu_pd(a[1] + aj);
+  __m256d r2 = _mm256_loadu_pd(a[2] + aj), r3 = _mm256_loadu_pd(a[3] + aj);
+  __m256d t0 = _mm256_unpacklo_pd(r0, r1), t1 = _mm256_unpackhi_pd(r0, r1);
+  __m256d t2 = _mm256_unpacklo_pd(r2, r3), t3 = _mm256_unpackhi_pd(r2, r3);
+  _mm256_storeu_pd(b[0] + bj, _mm256_permute2f128_pd(t0, t2, 0x20));
+  _mm256_storeu_pd(b[1] + bj, _mm256_permute2f128_pd(t1, t3, 0x20));
+  _mm256_storeu_pd(b[2] + bj, _mm256_permute2f128_pd(t0, t2, 0x31));
+  _mm256_storeu_pd(b[3] + bj, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+
+__attribute__((target("avx2"))) static void s21_mult_soa_avx2(
+    int m, int n, int k, const double *a, const double *b, double *c) {
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      __m256d lo = _mm256_setzero_pd(), hi = _mm256_setzero_pd();
+      for (int p = 0; p < k; p++) {
+        const double *ap = a + (i * k + p) * S21_BATCH_LANES;
+        const double *bp = b + (p * n + j) * S21_BATCH_LANES;
+        lo = _mm256_add_pd(
+            lo, _mm256_mul_pd(_mm256_loadu_pd(ap), _mm256_loadu_pd(bp)));
+        hi = _mm256_add_pd(hi, _mm256_mul_pd(_mm256_loadu_pd(ap + 4),
+                                             _mm256_loadu_pd(bp + 4)));
+      }
+      _mm256_storeu_pd(c + (i * n + j) * S21_BATCH_LANES, lo);
+      _mm256_storeu_pd(c + (i * n + j) * S21_BATCH_LANES + 4, hi);
+    }
+  }
+}
+
+__attribute__((target("avx512f"))) static void s21_add_avx512(const double *a,
+                                                              const double *b,
+                                                              double *r,
+                                                              int n) {
+  int j = 0;
+  for (; j + 8 <= n; j += 8)
+    _mm512_storeu_pd(r + j, _mm512_add_pd(_mm512_loadu_pd(a + j),
+                                          _mm512_loadu_pd(b + j)));
+  s21_add_avx2(a + j, b + j, r + j, n - j);
+}
+
+__attribute__((target("avx512f"))) static void s21_sub_avx512(const double *a,
+                                                              const double *b,
+                                                              double *r,
+                                                              int n) {
+  int j = 0;
+  for (; j + 8 <= n; j += 8)
+    _mm512_storeu_pd(r + j, _mm512_sub_pd(_mm512_loadu_pd(a + j),
+                                          _mm512_loadu_pd(b + j)));
+  s21_sub_avx2(a + j, b + j, r + j, n - j);
+}
+
+__attribute__((target("avx512f"))) static void s21_scale_avx512(
+    const double *a, double k, double *r, int n) {
+  __m512d vk = _mm512_set1_pd(k);
+  int j = 0;
+  for (; j + 8 <= n; j += 8)
+    _mm512_storeu_pd(r + j, _mm512_mul_pd(_mm512_loadu_pd(a + j), vk));
+  s21_scale_avx2(a + j, k, r + j, n - j);
+}
+
+__attribute__((target("avx512f"))) static void s21_axpy_avx512(
+    const double *a, double k, double *r, int n) {
+  __m512d vk = _mm512_set1_pd(k);
+  int j = 0;
+  for (; j + 8 <= n; j += 8)
+    _mm512_storeu_pd(r + j,
+                     _mm512_add_pd(_mm512_loadu_pd(r + j),
+                                   _mm512_mul_pd(_mm512_loadu_pd(a + j), vk)));
+  s21_axpy_avx2(a + j, k, r + j, n - j);
+}
+
+__attribute__((target("avx512f"))) static int s21_eq_avx512(const double *a,
+                                                            const double *b,
+                                                            int n) {
+  __m512d hi = _mm512_set1_pd(S21_EPS), lo = _mm512_set1_pd(-S21_EPS);
+  int ret = TRUE, j = 0;
+  for (; j + 8 <= n && ret; j += 8) {
+    __m512d d = _mm512_sub_pd(_mm512_loadu_pd(a + j), _mm512_loadu_pd(b + j));
+    __mmask8 in = _mm512_cmp_pd_mask(d, hi, _CMP_LT_OQ) &
+                  _mm512_cmp_pd_mask(d, lo, _CMP_GT_OQ);
+    ret = in == 0xff;
+  }
+  return ret && s21_eq_avx2(a + j, b + j, n - j);
+}
+
+__attribute__((target("avx512f"))) static void s21_mult_soa_avx512(
+    int m, int n, int k, const double *a, const double *b, double *c) {
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      __m512d acc = _mm512_setzero_pd();
+      for (int p = 0; p < k; p++) {
+        acc = _mm512_add_pd(
+            acc,
+            _mm512_mul_pd(_mm512_loadu_pd(a + (i * k + p) * S21_BATCH_LANES),
+                          _mm512_loadu_pd(b + (p * n + j) * S21_BATCH_LANES)));
+      }
+      _mm512_storeu_pd(c + (i * n + j) * S21_BATCH_LANES, acc);
+    }
+  }
+}
+
+__attribute__((target("avx2"))) static double s21_gather_dot_avx2(
+    const double *v, const int *index, const double *x, int n) {
+  __m256d acc = _mm256_setzero_pd();
+  int p = 0;
+  for (; p + 4 <= n; p += 4) {
+    __m128i i = _mm_loadu_si128((const __m128i *)(index + p));
+    acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_loadu_pd(v + p),
+                                           _mm256_i32gather_pd(x, i, 8)));
+  }
+  double lanes[4];
+  _mm256_storeu_pd(lanes, acc);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+         s21_gather_dot_scalar(v + p, index + p, x, n - p);
+}
+
+__attribute__((target("avx512f"))) static double s21_gather_dot_avx512(
+    const double *v, const int *index, const double *x, int n) {
+  __m512d acc = _mm512_setzero_pd();
+  int p = 0;
+  for (; p + 8 <= n; p += 8) {
+    __m256i i = _mm256_loadu_si256((const __m256i *)(index + p));
+    acc = _mm512_add_pd(acc, _mm512_mul_pd(_mm512_loadu_pd(v + p),
+                                           _mm512_i32gather_pd(i, x, 8)));
+  }
+  return _mm512_reduce_add_pd(acc) +
+         s21_gather_dot_avx2(v + p, index + p, x, n - p);
+}
+
+static const s21_kernels_t s21_kernels_sse2 = {
+    S21_ISA_SSE2, s21_add_sse2, s21_sub_sse2, s21_scale_sse2, s21_axpy_sse2,
+    s21_eq_sse2, s21_transpose4_sse2, s21_stream_sse2, s21_mult_soa_sse2,
+    s21_gather_dot_scalar};
+
+static const s21_kernels_t s21_kernels_avx2 = {
+    S21_ISA_AVX2, s21_add_avx2, s21_sub_avx2, s21_scale_avx2, s21_axpy_avx2,
+    s21_eq_avx2, s21_transpose4_avx2, s21_stream_sse2, s21_mult_soa_avx2,
+    s21_gather_dot_avx2};
+
+static const s21_kernels_t s21_kernels_avx512 = {
+    S21_ISA_AVX512, s21_add_avx512, s21_sub_avx512, s21_scale_avx512,
+    s21_axpy_avx512, s21_eq_avx512, s21_transpose4_avx2, s21_stream_sse2,
+    s21_mult_soa_avx512, s21_gather_dot_avx512};
+
+#endif
+
+_Atomic(const s21_kernels_t *) s21_kernels = &s21_kernels_scalar;
+
+static int s21_detect_isa(void) {
+  int level = S21_ISA_SCALAR;
+#ifdef S21_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse2")) level = S21_ISA_SSE2;
+  if (level == S21_ISA_SSE2 && __builtin_cpu_supports("avx2"))
+    level = S21_ISA_AVX2;
+  if (level == S21_ISA_AVX2 && __builtin_cpu_supports("avx512f"))
+    level = S21_ISA_AVX512;
+#endif
+  return level;
+}
+
+int s21_set_isa_level(int level) {
+  int best = s21_detect_isa();
+  if (level < S21_ISA_SCALAR || level > best) level = best;
+  const s21_kernels_t *k = &s21_kernels_scalar;
+#ifdef S21_X86
+  if (level == S21_ISA_SSE2) k = &s21_kernels_sse2;
+  if (level == S21_ISA_AVX2) k = &s21_kernels_avx2;
+  if (level == S21_ISA_AVX512) k = &s21_kernels_avx512;
+#endif
+  atomic_store_explicit(&s21_kernels, k, memory_order_release);
+  return k->level;
+}
+
+int s21_isa_level(void) {
+  return atomic_load_explicit(&s21_kernels, memory_order_acquire)->level;
+}
+
+/* S21_MATRIX_ISA=scalar|sse2|avx2|avx512 caps the level picked at load */
+__attribute__((constructor)) static void s21_simd_init(void) {
+  static const char *names[] = {"scalar", "sse2", "avx2", "avx512"};
+  const char *env = getenv("S21_MATRIX_ISA");
+  int level = -1;
+  for (int i = 0; env && i < 4; i++) {
+    if (strcmp(env, names[i]) == 0) level = i;
+  }
+  s21_set_isa_level(level);
+}
@@ -0,0 +1,334 @@
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "s21_internal.h"
+
+#define S21_SPARSE_STRIPE 256
+/* multiply-adds below which a product stays on the calling thread */
+#define S21_SPARSE_PARALLEL (1 << 16)
+/* values are scaled in runs the int-sized kernels can take */
+#define S21_SPARSE_CHUNK (1 << 20)
+
+typedef struct {
+  const s21_sparse_t *a;
+  const double *x;
+  double *y;
+  double *partial;
+  int chunks;
+  matrix_t *b, *c;
+} s21_sparse_job_t;
+
+static int s21_is_valid_sparse(const s21_sparse_t *a) {
+  return a && a->ptr && a->rows > 0 && a->columns > 0 &&
+         (a->format == S21_SPARSE_CSR || a->format == S21_SPARSE_CSC);
+}
+
+/* rows of CSR, columns of CSC */
+static int s21_sparse_lines(const s21_sparse_t *a) {
+  return a->format == S21_SPARSE_CSR ? a->rows : a->columns;
+}
+
+static size_t s21_align_bytes(size_t bytes) {
+  return (bytes + S21_ALIGN - 1) / S21_ALIGN * S21_ALIGN;
+}
+
+int s21_sparse_create(int rows, int columns, size_t nnz, int format,
+                      s21_sparse_t *result) {
+  int ret = result && rows > 0 && columns > 0 &&
+                    (format == S21_SPARSE_CSR || format == S21_SPARSE_CSC) &&
+                    nnz <= (size_t)rows * columns && nnz <= SIZE_MAX / 64
+                ? OK
+                : ERROR;
+  if (ret == OK) {
+    int lines = format == S21_SPARSE_CSR ? rows : columns;
+    size_t values = s21_align_bytes(nnz * sizeof(double));
+    size_t ptr = s21_align_bytes(((size_t)lines + 1) * sizeof(size_t));
+    size_t bytes = values + ptr + s21_align_bytes(nnz * sizeof(int));
+    char *block = aligned_alloc(S21_ALIGN, bytes);
+    if (block) {
+      *result = (s21_sparse_t){.format = format,
+                               .rows = rows,
+                               .columns = columns,
+                               .nnz = nnz,
+                               .ptr = (size_t *)(block + values),
+                               .index = (int *)(block + values + ptr),
+                               .values = (double *)block};
+      memset(result->ptr, 0, ((size_t)lines + 1) * sizeof(size_t));
+      S21_STATS_ALLOC(bytes);
+    } else {
+      ret = ERROR;
+    }
+  }
+  return ret;
+}
+
+void s21_sparse_free(s21_sparse_t *a) {
+  if (a) {
+    free(a->values);
+    *a = (s21_sparse_t){0};
+  }
+}
+
+/* moves t into result, releasing what result held when it was an operand */
+static void s21_sparse_replace(s21_sparse_t *result, s21_sparse_t *t,
+                               const s21_sparse_t *a, const s21_sparse_t *b) {
+  if (result == a || result == b) s21_sparse_free(result);
+  *result = *t;
+}
+
+/*
+ * Entries are bucketed by line: ptr[l + 1] first counts line l, becomes its
+ * start in s21_sparse_starts, serves as the cursor of s21_sparse_place and
+ * is shifted back into place by s21_sparse_rewind.
+ */
+static void s21_sparse_starts(s21_sparse_t *s) {
+  int lines = s21_sparse_lines(s);
+  for (int l = 0; l < lines; l++) s->ptr[l + 1] += s->ptr[l];
+}
+
+static void s21_sparse_place(s21_sparse_t *s, int line, int other,
+                             double v) {
+  size_t q = s->ptr[line]++;
+  s->index[q] = other;
+  s->values[q] = v;
+}
+
+static void s21_sparse_rewind(s21_sparse_t *s) {
+  memmove(s->ptr + 1, s->ptr, sizeof(size_t) * s21_sparse_lines(s));
+  s->ptr[0] = 0;
+}
+
+int s21_sparse_from_matrix(matrix_t *a, int format, s21_sparse_t *result) {
+  int ret = s21_is_valid_matrix_t(a) && result ? OK : ERROR;
+  size_t nnz = 0;
+  for (int i = 0; ret == OK && i < a->rows; i++) {
+    for (int j = 0; j < a->columns; j++) nnz += a->matrix[i][j] != 0.0;
+  }
+  if (ret == OK)
+    ret = s21_sparse_create(a->rows, a->columns, nnz, format, result);
+  if (ret == OK) {
+    int csr = format == S21_SPARSE_CSR;
+    for (int i = 0; i < a->rows; i++) {
+      for (int j = 0; j < a->columns; j++) {
+        if (a->matrix[i][j] != 0.0) result->ptr[(csr ? i : j) + 1]++;
+      }
+    }
+    s21_sparse_starts(result);
+    for (int i = 0; i < a->rows; i++) {
+      for (int j = 0; j < a->columns; j++) {
+        double v = a->matrix[i][j];
+        if (v != 0.0) s21_sparse_place(result, csr ? i : j, csr ? j : i, v);
+      }
+    }
+    s21_sparse_rewind(result);
+  }
+  return ret;
+}
+
+int s21_sparse_to_matrix(s21_sparse_t *a, matrix_t *result) {
+  int ret = s21_is_valid_sparse(a) && result ? OK : ERROR;
+  if (ret == OK) ret = s21_create_matrix(a->rows, a->columns, result);
+  for (int l = 0; ret == OK && l < s21_sparse_lines(a); l++) {
+    for (size_t p = a->ptr[l]; p < a->ptr[l + 1]; p++) {
+      if (a->format == S21_SPARSE_CSR)
+        result->matrix[l][a->index[p]] = a->values[p];
+      else
+        result->matrix[a->index[p]][l] = a->values[p];
+    }
+  }
+  return ret;
+}
+
+/* t has the other format and a's nnz; lines of a come out in order */
+static void s21_sparse_transpose(const s21_sparse_t *a, s21_sparse_t *t) {
+  for (size_t p = 0; p < a->nnz; p++) t->ptr[a->index[p] + 1]++;
+  s21_sparse_starts(t);
+  for (int l = 0; l < s21_sparse_lines(a); l++) {
+    for (size_t p = a->ptr[l]; p < a->ptr[l + 1]; p++)
+      s21_sparse_place(t, a->index[p], l, a->values[p]);
+  }
+  s21_sparse_rewind(t);
+}
+
+int s21_sparse_convert(s21_sparse_t *a, int format, s21_sparse_t *result) {
+  int ret = s21_is_valid_sparse(a) && result ? OK : ERROR;
+  s21_sparse_t t = {0};
+  if (ret == OK)
+    ret = s21_sparse_create(a->rows, a->columns, a->nnz, format, &t);
+  if (ret == OK && format == a->format) {
+    memcpy(t.ptr, a->ptr, sizeof(size_t) * (s21_sparse_lines(a) + 1));
+    memcpy(t.index, a->index, sizeof(int) * a->nnz);
+    memcpy(t.values, a->values, sizeof(double) * a->nnz);
+  } else if (ret == OK) {
+    s21_sparse_transpose(a, &t);
+  }
+  if (ret == OK) s21_sparse_replace(result, &t, a, NULL);
+  return ret;
+}
+
+static void s21_spmv_stripe(void *ctx, int task) {
+  s21_sparse_job_t *job = ctx;
+  const s21_sparse_t *a = job->a;
+  int first = task * S21_SPARSE_STRIPE, last = first + S21_SPARSE_STRIPE;
+  if (last > a->rows) last = a->rows;
+  for (int i = first; i < last; i++) {
+    size_t p = a->ptr[i];
+    job->y[i] = s21_kernels->gather_dot(a->values + p, a->index + p, job->x,
+                                        (int)(a->ptr[i + 1] - p));
+  }
+}
+
+/* chunk c of the columns scatters into y or its own slice of partial */
+static void s21_spmv_columns(void *ctx, int task) {
+  s21_sparse_job_t *job = ctx;
+  const s21_sparse_t *a = job->a;
+  int first = (int)((long)a->columns * task / job->chunks);
+  int last = (int)((long)a->columns * (task + 1) / job->chunks);
+  double *y = task ? job->partial + (size_t)(task - 1) * a->rows : job->y;
+  memset(y, 0, sizeof(double) * a->rows);
+  for (int j = first; j < last; j++) {
+    double xj = job->x[j];
+    for (size_t p = a->ptr[j]; p < a->ptr[j + 1]; p++)
+      y[a->index[p]] += a->values[p] * xj;
+  }
+}
+
+int s21_sparse_mult_vector(s21_sparse_t *a, const double *x, double *y) {
+  S21_STATS_BEGIN(S21_STATS_SPARSE_MULT_VECTOR);
+  int ret = s21_is_valid_sparse(a) && x && y ? OK : ERROR;
+  s21_sparse_job_t job = {.a = a, .x = x, .y = y, .chunks = 1};
+  int parallel = ret == OK && a->nnz >= S21_SPARSE_PARALLEL;
+  if (ret == OK && a->format == S21_SPARSE_CSR) {
+    int stripes = (a->rows + S21_SPARSE_STRIPE - 1) / S21_SPARSE_STRIPE;
+    if (parallel) {
+      s21_parallel_for(stripes, s21_spmv_stripe, &job);
+    } else {
+      for (int t = 0; t < stripes; t++) s21_spmv_stripe(&job, t);
+    }
+  } else if (ret == OK) {
+    if (parallel) {
+      job.chunks = s21_get_num_threads();
+      if (job.chunks > a->columns) job.chunks = a->columns;
+    }
+    if (job.chunks > 1)
+      job.partial = malloc(sizeof(double) * a->rows * (job.chunks - 1));
+    if (!job.partial) job.chunks = 1;
+    s21_parallel_for(job.chunks, s21_spmv_columns, &job);
+    for (int c = 1; c < job.chunks; c++)
+      s21_kernels->add(y, job.partial + (size_t)(c - 1) * a->rows, y,
+                       a->rows);
+    free(job.partial);
+  }
+  S21_STATS_END(ret == OK ? 2.0 * a->nnz : 0.0);
+  return ret;
+}
+
+static void s21_spmm_stripe(void *ctx, int task) {
+  s21_sparse_job_t *job = ctx;
+  const s21_sparse_t *a = job->a;
+  int first = task * S21_SPARSE_STRIPE, last = first + S21_SPARSE_STRIPE;
+  if (last > a->rows) last = a->rows;
+  for (int i = first; i < last; i++) {
+    for (size_t p = a->ptr[i]; p < a->ptr[i + 1]; p++)
+      s21_kernels->axpy(job->b->matrix[a->index[p]], a->values[p],
+                        job->c->matrix[i], job->b->columns);
+  }
+}
+
+int s21_sparse_mult_matrix(s21_sparse_t *a, matrix_t *b, matrix_t *result) {
+  S21_STATS_BEGIN(S21_STATS_SPARSE_MULT_MATRIX);
+  int ret = s21_is_valid_sparse(a) && s21_is_valid_matrix_t(b) && result
+                ? OK
+                : ERROR;
+  if (ret == OK && a->columns != b->rows) ret = CALCULATION_ERROR;
+  s21_sparse_t csr = {0};
+  s21_sparse_job_t job = {.a = a, .b = b, .c = result};
+  if (ret == OK && a->format == S21_SPARSE_CSC) {
+    ret = s21_sparse_convert(a, S21_SPARSE_CSR, &csr);
+    job.a = &csr;
+    S21_STATS_TEMPORARY();
+  }
+  if (ret == OK) ret = s21_create_matrix(a->rows, b->columns, result);
+  if (ret == OK) {
+    int stripes = (a->rows + S21_SPARSE_STRIPE - 1) / S21_SPARSE_STRIPE;
+    if ((double)a->nnz * b->columns >= S21_SPARSE_PARALLEL) {
+      s21_parallel_for(stripes, s21_spmm_stripe, &job);
+    } else {
+      for (int t = 0; t < stripes; t++) s21_spmm_stripe(&job, t);
+    }
+  }
+  s21_sparse_free(&csr);
+  S21_STATS_END(ret == OK ? 2.0 * a->nnz * b->columns : 0.0);
+  return ret;
+}
+
+/*
+ * Merges line l of a and b into out, or only counts it when out is NULL;
+ * entries that cancel to zero are dropped.
+ */
+static size_t s21_sparse_merge(const s21_sparse_t *a, const s21_sparse_t *b,
+                               int l, s21_sparse_t *out) {
+  size_t p = a->ptr[l], q = b->ptr[l], count = 0;
+  while (p < a->ptr[l + 1] || q < b->ptr[l + 1]) {
+    int ia = p < a->ptr[l + 1] ? a->index[p] : INT_MAX;
+    int ib = q < b->ptr[l + 1] ? b->index[q] : INT_MAX;
+    int i = ia < ib ? ia : ib;
+    double v = 0.0;
+    if (ia == i) v += a->values[p++];
+    if (ib == i) v += b->values[q++];
+    if (v != 0.0 && out) {
+      out->index[out->ptr[l] + count] = i;
+      out->values[out->ptr[l] + count] = v;
+    }
+    count += v != 0.0;
+  }
+  return count;
+}
+
+int s21_sparse_sum(s21_sparse_t *a, s21_sparse_t *b, s21_sparse_t *result) {
+  int ret = s21_is_valid_sparse(a) && s21_is_valid_sparse(b) && result
+                ? OK
+                : ERROR;
+  if (ret == OK && (a->rows != b->rows || a->columns != b->columns))
+    ret = CALCULATION_ERROR;
+  s21_sparse_t same = {0}, t = {0};
+  const s21_sparse_t *other = b;
+  if (ret == OK && b->format != a->format) {
+    ret = s21_sparse_convert(b, a->format, &same);
+    other = &same;
+  }
+  int lines = ret == OK ? s21_sparse_lines(a) : 0;
+  size_t *counts = ret == OK ? malloc(sizeof(size_t) * lines) : NULL;
+  size_t nnz = 0;
+  if (ret == OK && !counts) ret = ERROR;
+  for (int l = 0; l < lines && ret == OK; l++) {
+    counts[l] = s21_sparse_merge(a, other, l, NULL);
+    nnz += counts[l];
+  }
+  if (ret == OK)
+    ret = s21_sparse_create(a->rows, a->columns, nnz, a->format, &t);
+  if (ret == OK) {
+    for (int l = 0; l < lines; l++) {
+      t.ptr[l + 1] = t.ptr[l] + counts[l];
+      s21_sparse_merge(a, other, l, &t);
+    }
+    s21_sparse_replace(result, &t, a, b);
+  }
+  free(counts);
+  s21_sparse_free(&same);
+  return ret;
+}
+
+int s21_sparse_mult_number(s21_sparse_t *a, double number,
+                           s21_sparse_t *result) {
+  int ret = s21_is_valid_sparse(a) && result ? OK : ERROR;
+  if (ret == OK && result != a) ret = s21_sparse_convert(a, a->format, result);
+  for (size_t p = 0; ret == OK && p < result->nnz; p += S21_SPARSE_CHUNK) {
+    size_t n = result->nnz - p;
+    if (n > S21_SPARSE_CHUNK) n = S21_SPARSE_CHUNK;
+    s21_kernels->scale(result->values + p, number, result->values + p,
+                       (int)n);
+  }
+  return ret;
+}
@@ -0,0 +1,188 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+
+#include "s21_internal.h"
+
+static const char *const s21_stats_names[S21_STATS_COUNT] = {
+    "s21_create_matrix",       "s21_remove_matrix",
+    "s21_eq_matrix",           "s21_sum_matrix",
+    "s21_sub_matrix",          "s21_mult_number",
+    "s21_mult_matrix",         "s21_transpose",
+    "s21_calc_complements",    "s21_determinant",
+    "s21_inverse_matrix",      "s21_lu_factor",
+    "s21_lu_solve",            "s21_mult_matrix_batched",
+    "s21_determinant_batched", "s21_inverse_batched",
+    "s21_expr_eval",           "s21_sparse_mult_vector",
+    "s21_sparse_mult_matrix",  "s21_cholesky",
+    "s21_solve"};
+
+const char *s21_stats_name(int fn) {
+  return fn >= 0 && fn < S21_STATS_COUNT ? s21_stats_names[fn] : NULL;
+}
+
+#ifdef S21_STATS
+
+#define S21_CALLS 0
+#define S21_FLOPS 1
+#define S21_BYTES 2
+#define S21_TEMPORARIES 3
+#define S21_NANOSECONDS 4
+#define S21_FIELDS 5
+
+typedef unsigned long long s21_totals_t[S21_STATS_COUNT][S21_FIELDS];
+
+/* written only by its thread, read by any thread taking a snapshot */
+typedef struct s21_stats_block {
+  _Atomic unsigned long long counters[S21_STATS_COUNT][S21_FIELDS];
+  struct s21_stats_block *next;
+} s21_stats_block_t;
+
+static _Thread_local s21_stats_block_t *s21_stats_local;
+static _Thread_local int s21_stats_depth;
+static _Thread_local int s21_stats_current;
+
+/* live blocks, and what exited threads and the last reset left behind */
+static pthread_mutex_t s21_stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static s21_stats_block_t *s21_stats_blocks;
+static s21_totals_t s21_stats_retired;
+static s21_totals_t s21_stats_baseline;
+static pthread_key_t s21_stats_key;
+static pthread_once_t s21_stats_once = PTHREAD_ONCE_INIT;
+
+static void s21_stats_thread_exit(void *block) {
+  pthread_mutex_lock(&s21_stats_lock);
+  s21_stats_block_t **p = &s21_stats_blocks;
+  while (*p && *p != block) p = &(*p)->next;
+  if (*p) *p = (*p)->next;
+  for (int f = 0; f < S21_STATS_COUNT; f++) {
+    for (int i = 0; i < S21_FIELDS; i++) {
+      s21_stats_retired[f][i] += atomic_load_explicit(
+          &((s21_stats_block_t *)block)->counters[f][i], memory_order_relaxed);
+    }
+  }
+  pthread_mutex_unlock(&s21_stats_lock);
+  free(block);
+  s21_stats_local = NULL;
+}
+
+static void s21_stats_make_key(void) {
+  pthread_key_create(&s21_stats_key, s21_stats_thread_exit);
+}
+
+static s21_stats_block_t *s21_stats_block(void) {
+  if (!s21_stats_local) {
+    pthread_once(&s21_stats_once, s21_stats_make_key);
+    s21_stats_block_t *b = calloc(1, sizeof(s21_stats_block_t));
+    if (b) {
+      pthread_mutex_lock(&s21_stats_lock);
+      b->next = s21_stats_blocks;
+      s21_stats_blocks = b;
+      pthread_mutex_unlock(&s21_stats_lock);
+      pthread_setspecific(s21_stats_key, b);
+      s21_stats_local = b;
+    }
+  }
+  return s21_stats_local;
+}
+
+/* the only writer needs no read-modify-write, just an untorn store */
+static void s21_stats_add(int fn, int field, unsigned long long v) {
+  s21_stats_block_t *b = s21_stats_block();
+  if (b) {
+    _Atomic unsigned long long *c = &b->counters[fn][field];
+    atomic_store_explicit(
+        c, atomic_load_explicit(c, memory_order_relaxed) + v,
+        memory_order_relaxed);
+  }
+}
+
+static unsigned long long s21_stats_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+s21_stats_scope_t s21_stats_begin(int fn) {
+  s21_stats_scope_t scope = {fn, s21_stats_depth++ == 0, 0};
+  if (scope.outer) {
+    s21_stats_current = fn;
+    scope.start = s21_stats_now();
+  }
+  return scope;
+}
+
+void s21_stats_end(s21_stats_scope_t scope, double flops) {
+  s21_stats_depth--;
+  if (scope.outer) {
+    s21_stats_add(scope.fn, S21_NANOSECONDS, s21_stats_now() - scope.start);
+    s21_stats_add(scope.fn, S21_CALLS, 1);
+    s21_stats_add(scope.fn, S21_FLOPS, (unsigned long long)flops);
+  }
+}
+
+void s21_stats_alloc(size_t bytes, int temporaries) {
+  if (s21_stats_depth > 0) {
+    s21_stats_add(s21_stats_current, S21_BYTES, bytes);
+    s21_stats_add(s21_stats_current, S21_TEMPORARIES, temporaries);
+  }
+}
+
+/* callers hold s21_stats_lock */
+static void s21_stats_totals(s21_totals_t t) {
+  memcpy(t, s21_stats_retired, sizeof(s21_totals_t));
+  for (s21_stats_block_t *b = s21_stats_blocks; b; b = b->next) {
+    for (int f = 0; f < S21_STATS_COUNT; f++) {
+      for (int i = 0; i < S21_FIELDS; i++) {
+        t[f][i] +=
+            atomic_load_explicit(&b->counters[f][i], memory_order_relaxed);
+      }
+    }
+  }
+}
+
+int s21_stats_enabled(void) { return TRUE; }
+
+int s21_stats_snapshot(s21_stats_t *result) {
+  int ret = result ? OK : ERROR;
+  if (ret == OK) {
+    s21_totals_t t;
+    pthread_mutex_lock(&s21_stats_lock);
+    s21_stats_totals(t);
+    for (int f = 0; f < S21_STATS_COUNT; f++) {
+      for (int i = 0; i < S21_FIELDS; i++) t[f][i] -= s21_stats_baseline[f][i];
+    }
+    pthread_mutex_unlock(&s21_stats_lock);
+    for (int f = 0; f < S21_STATS_COUNT; f++) {
+      result[f].calls = t[f][S21_CALLS];
+      result[f].flops = t[f][S21_FLOPS];
+      result[f].bytes_allocated = t[f][S21_BYTES];
+      result[f].temporaries = t[f][S21_TEMPORARIES];
+      result[f].nanoseconds = t[f][S21_NANOSECONDS];
+    }
+  }
+  return ret;
+}
+
+void s21_stats_reset(void) {
+  pthread_mutex_lock(&s21_stats_lock);
+  s21_stats_totals(s21_stats_baseline);
+  pthread_mutex_unlock(&s21_stats_lock);
+}
+
+#else
+
+int s21_stats_enabled(void) { return FALSE; }
+
+int s21_stats_snapshot(s21_stats_t *result) {
+  int ret = result ? OK : ERROR;
+  if (ret == OK) memset(result, 0, sizeof(s21_stats_t) * S21_STATS_COUNT);
+  return ret;
+}
+
+void s21_stats_reset(void) {}
+
+#endif
@@ -0,0 +1,187 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "s21_internal.h"
+
+#define S21_STRASSEN_MIN 64
+/* the crossover "make bench_strassen" measured on the development machine */
+#define S21_STRASSEN_DEFAULT 128
+
+/* rows[i][col..] of a matrix, so quadrants need no copies */
+typedef struct {
+  double *const *rows;
+  int col;
+} s21_view_t;
+
+static int s21_cutoff = S21_STRASSEN_DEFAULT;
+
+static s21_view_t s21_quad(s21_view_t v, int row, int col) {
+  s21_view_t q = {v.rows + row, v.col + col};
+  return q;
+}
+
+static s21_view_t s21_whole(matrix_t *m) {
+  s21_view_t v = {m->matrix, 0};
+  return v;
+}
+
+static void s21_view_add(s21_view_t c, s21_view_t a, s21_view_t b, int m,
+                         int n) {
+  for (int i = 0; i < m; i++)
+    s21_kernels->add(a.rows[i] + a.col, b.rows[i] + b.col, c.rows[i] + c.col,
+                     n);
+}
+
+static void s21_view_sub(s21_view_t c, s21_view_t a, s21_view_t b, int m,
+                         int n) {
+  for (int i = 0; i < m; i++)
+    s21_kernels->sub(a.rows[i] + a.col, b.rows[i] + b.col, c.rows[i] + c.col,
+                     n);
+}
+
+/* c = a * b on the packed kernel, which wants row tables from column 0 */
+static int s21_view_gemm(s21_view_t a, s21_view_t b, s21_view_t c, int m,
+                         int n, int k) {
+  int ret = OK;
+  double **t = s21_scratch_alloc(sizeof(double *) * (2 * m + k));
+  if (!t) {
+    ret = ERROR;
+  } else {
+    for (int i = 0; i < m; i++) {
+      t[i] = a.rows[i] + a.col;
+      t[m + k + i] = c.rows[i] + c.col;
+      memset(t[m + k + i], 0, sizeof(double) * n);
+    }
+    for (int r = 0; r < k; r++) t[m + r] = b.rows[r] + b.col;
+    s21_gemm(m, n, k, 1.0, t, t + m, t + m + k);
+  }
+  s21_scratch_free(t);
+  return ret;
+}
+
+static int s21_winograd(s21_view_t a, s21_view_t b, s21_view_t c, int m,
+                        int n, int k, int depth);
+
+/*
+ * The seven products and fifteen additions of Winograd's variant, ordered
+ * so that two temporaries suffice (Boyer, Dumas, Pernet and Zhou, 2009):
+ * x holds the S sums and then P1, y holds the T sums, the rest lives in c.
+ */
+static int s21_winograd_step(s21_view_t a, s21_view_t b, s21_view_t c,
+                             s21_view_t x, s21_view_t y, int m, int n, int k,
+                             int depth) {
+  s21_view_t a11 = a, a12 = s21_quad(a, 0, k), a21 = s21_quad(a, m, 0),
+             a22 = s21_quad(a, m, k);
+  s21_view_t b11 = b, b12 = s21_quad(b, 0, n), b21 = s21_quad(b, k, 0),
+             b22 = s21_quad(b, k, n);
+  s21_view_t c11 = c, c12 = s21_quad(c, 0, n), c21 = s21_quad(c, m, 0),
+             c22 = s21_quad(c, m, n);
+  int ret = OK;
+  s21_view_sub(x, a11, a21, m, k);
+  s21_view_sub(y, b22, b12, k, n);
+  ret = s21_winograd(x, y, c21, m, n, k, depth);
+  s21_view_add(x, a21, a22, m, k);
+  s21_view_sub(y, b12, b11, k, n);
+  if (ret == OK) ret = s21_winograd(x, y, c22, m, n, k, depth);
+  s21_view_sub(x, x, a11, m, k);
+  s21_view_sub(y, b22, y, k, n);
+  if (ret == OK) ret = s21_winograd(x, y, c12, m, n, k, depth);
+  s21_view_sub(x, a12, x, m, k);
+  if (ret == OK) ret = s21_winograd(x, b22, c11, m, n, k, depth);
+  if (ret == OK) ret = s21_winograd(a11, b11, x, m, n, k, depth);
+  s21_view_add(c12, x, c12, m, n);
+  s21_view_add(c21, c12, c21, m, n);
+  s21_view_add(c12, c12, c22, m, n);
+  s21_view_add(c22, c21, c22, m, n);
+  s21_view_add(c12, c12, c11, m, n);
+  s21_view_sub(y, y, b21, k, n);
+  if (ret == OK) ret = s21_winograd(a22, y, c11, m, n, k, depth);
+  s21_view_sub(c21, c21, c11, m, n);
+  if (ret == OK) ret = s21_winograd(a12, b21, c11, m, n, k, depth);
+  s21_view_add(c11, x, c11, m, n);
+  return ret;
+}
+
+/* c = a * b; every dimension halves evenly depth more times */
+static int s21_winograd(s21_view_t a, s21_view_t b, s21_view_t c, int m,
+                        int n, int k, int depth) {
+  int ret = OK;
+  if (depth == 0) {
+    ret = s21_view_gemm(a, b, c, m, n, k);
+  } else {
+    s21_arena_mark_t mark = s21_arena_begin();
+    matrix_t x = {0}, y = {0};
+    int hm = m / 2, hn = n / 2, hk = k / 2;
+    ret = s21_scratch_matrix(hm, hk > hn ? hk : hn, &x);
+    if (ret == OK) ret = s21_scratch_matrix(hk, hn, &y);
+    if (ret == OK)
+      ret = s21_winograd_step(a, b, c, s21_whole(&x), s21_whole(&y), hm, hn,
+                              hk, depth - 1);
+    s21_remove_matrix(&x);
+    s21_remove_matrix(&y);
+    s21_arena_end(mark);
+  }
+  return ret;
+}
+
+/* odd sizes are zero padded once up front rather than peeled per level */
+static int s21_winograd_padded(int m, int n, int k, double *const *a,
+                               double *const *b, double **c, int depth) {
+  int unit = 1 << depth, ret = OK;
+  int pm = (m + unit - 1) / unit * unit, pn = (n + unit - 1) / unit * unit,
+      pk = (k + unit - 1) / unit * unit;
+  s21_arena_mark_t mark = s21_arena_begin();
+  matrix_t pa = {0}, pb = {0}, pc = {0};
+  ret = s21_scratch_matrix(pm, pk, &pa);
+  if (ret == OK) ret = s21_scratch_matrix(pk, pn, &pb);
+  if (ret == OK) ret = s21_scratch_matrix(pm, pn, &pc);
+  if (ret == OK) {
+    for (int i = 0; i < m; i++)
+      memcpy(pa.matrix[i], a[i], sizeof(double) * k);
+    for (int i = 0; i < k; i++)
+      memcpy(pb.matrix[i], b[i], sizeof(double) * n);
+    ret = s21_winograd(s21_whole(&pa), s21_whole(&pb), s21_whole(&pc), pm,
+                       pn, pk, depth);
+  }
+  for (int i = 0; i < m && ret == OK; i++)
+    memcpy(c[i], pc.matrix[i], sizeof(double) * n);
+  s21_remove_matrix(&pa);
+  s21_remove_matrix(&pb);
+  s21_remove_matrix(&pc);
+  s21_arena_end(mark);
+  return ret;
+}
+
+/* skinny products gain little from recursion and lose a lot to padding;
+ * a failed run leaves c zeroed for the caller to fall back on s21_gemm */
+int s21_strassen(int m, int n, int k, double *const *a, double *const *b,
+                 double **c) {
+  int ret = FALSE;
+  int lo = m < n ? m : n, hi = m < n ? n : m;
+  if (k < lo) lo = k;
+  if (k > hi) hi = k;
+  if (s21_cutoff > 0 && lo > s21_cutoff && hi <= 2 * lo) {
+    int depth = 0;
+    while ((lo >> depth) > s21_cutoff) depth++;
+    if (m % (1 << depth) || n % (1 << depth) || k % (1 << depth)) {
+      ret = s21_winograd_padded(m, n, k, a, b, c, depth) == OK;
+    } else {
+      s21_view_t va = {a, 0}, vb = {b, 0}, vc = {c, 0};
+      ret = s21_winograd(va, vb, vc, m, n, k, depth) == OK;
+      for (int i = 0; i < m && !ret; i++) memset(c[i], 0, sizeof(double) * n);
+    }
+  }
+  return ret;
+}
+
+void s21_set_strassen_cutoff(int n) {
+  s21_cutoff = n <= 0 ? 0 : n < S21_STRASSEN_MIN ? S21_STRASSEN_MIN : n;
+}
+
+int s21_strassen_cutoff(void) { return s21_cutoff; }
+
+/* S21_STRASSEN_CUTOFF overrides the default with a locally measured one */
+__attribute__((constructor)) static void s21_strassen_init(void) {
+  const char *env = getenv("S21_STRASSEN_CUTOFF");
+  if (env) s21_set_strassen_cutoff((int)strtol(env, NULL, 10));
+}
@@ -0,0 +1,139 @@
+#include <string.h>
+
+#include "s21_internal.h"
+
+#define S21_TRANSPOSE_LEAF 32
+#define S21_TRANSPOSE_STRIPE 256
+#define S21_TRANSPOSE_PARALLEL (1024 * 1024)
+#define S21_TRANSPOSE_STREAM (2 * 1024 * 1024)
+
+typedef struct {
+  double *const *a;
+  double *const *b;
+  int m, n;
+  int stream;
+} s21_transpose_job_t;
+
+/* b[c][bj + r] = a[r][aj + c] for an m x n block */
+static void s21_transpose_leaf(double *const *a, int aj, double *const *b,
+                               int bj, int m, int n) {
+  int r = 0;
+  for (; r + 4 <= m; r += 4) {
+    int c = 0;
+    for (; c + 4 <= n; c += 4)
+      s21_kernels->transpose4(a + r, aj + c, b + c, bj + r);
+    for (; c < n; c++)
+      for (int k = r; k < r + 4; k++) b[c][bj + k] = a[k][aj + c];
+  }
+  for (; r < m; r++)
+    for (int c = 0; c < n; c++) b[c][bj + r] = a[r][aj + c];
+}
+
+/* a leaf staged in a tile so it can be streamed out whole */
+static void s21_transpose_leaf_stream(double *const *a, int aj,
+                                      double *const *b, int bj, int m, int n) {
+  double buf[S21_TRANSPOSE_LEAF * S21_TRANSPOSE_LEAF]
+      __attribute__((aligned(S21_ALIGN)));
+  double *t[S21_TRANSPOSE_LEAF];
+  for (int c = 0; c < n; c++) t[c] = buf + c * S21_TRANSPOSE_LEAF;
+  s21_transpose_leaf(a, aj, t, 0, m, n);
+  s21_kernels->stream(b, bj, t, m, n);
+}
+
+/* halves the longer side, keeping splits on 4-element boundaries */
+static void s21_transpose_rec(double *const *a, int aj, double *const *b,
+                              int bj, int m, int n, int stream) {
+  if (m <= S21_TRANSPOSE_LEAF && n <= S21_TRANSPOSE_LEAF) {
+    if (stream)
+      s21_transpose_leaf_stream(a, aj, b, bj, m, n);
+    else
+      s21_transpose_leaf(a, aj, b, bj, m, n);
+  } else if (m >= n) {
+    int h = m / 2 & ~3;
+    s21_transpose_rec(a, aj, b, bj, h, n, stream);
+    s21_transpose_rec(a + h, aj, b, bj + h, m - h, n, stream);
+  } else {
+    int h = n / 2 & ~3;
+    s21_transpose_rec(a, aj, b, bj, m, h, stream);
+    s21_transpose_rec(a, aj + h, b + h, bj, m, n - h, stream);
+  }
+}
+
+/* exchanges the m x n block at (i, j) with the transpose of its mirror */
+static void s21_transpose_swap(double *const *a, int i, int j, int m, int n) {
+  if (m <= S21_TRANSPOSE_LEAF && n <= S21_TRANSPOSE_LEAF) {
+    double buf[S21_TRANSPOSE_LEAF * S21_TRANSPOSE_LEAF];
+    double *t[S21_TRANSPOSE_LEAF];
+    for (int c = 0; c < n; c++) t[c] = buf + c * S21_TRANSPOSE_LEAF;
+    s21_transpose_leaf(a + i, j, t, 0, m, n);
+    s21_transpose_leaf(a + j, i, a + i, j, n, m);
+    for (int c = 0; c < n; c++)
+      memcpy(a[j + c] + i, t[c], m * sizeof(double));
+  } else if (m >= n) {
+    int h = m / 2 & ~3;
+    s21_transpose_swap(a, i, j, h, n);
+    s21_transpose_swap(a, i + h, j, m - h, n);
+  } else {
+    int h = n / 2 & ~3;
+    s21_transpose_swap(a, i, j, m, h);
+    s21_transpose_swap(a, i, j + h, m, n - h);
+  }
+}
+
+/* transposes the n x n diagonal block at (i, i) in place */
+static void s21_transpose_diag(double *const *a, int i, int n) {
+  if (n <= S21_TRANSPOSE_LEAF) {
+    for (int r = i; r < i + n; r++) {
+      for (int c = r + 1; c < i + n; c++) {
+        double t = a[r][c];
+        a[r][c] = a[c][r];
+        a[c][r] = t;
+      }
+    }
+  } else {
+    int h = n / 2 & ~3;
+    s21_transpose_diag(a, i, h);
+    s21_transpose_diag(a, i + h, n - h);
+    s21_transpose_swap(a, i, i + h, h, n - h);
+  }
+}
+
+static void s21_transpose_stripe(void *ctx, int task) {
+  s21_transpose_job_t *job = ctx;
+  int i = task * S21_TRANSPOSE_STRIPE;
+  int m = job->m - i;
+  if (m > S21_TRANSPOSE_STRIPE) m = S21_TRANSPOSE_STRIPE;
+  s21_transpose_rec(job->a + i, 0, job->b, i, m, job->n, job->stream);
+}
+
+/* a square stripe owns its diagonal block and everything right of it */
+static void s21_transpose_square_stripe(void *ctx, int task) {
+  s21_transpose_job_t *job = ctx;
+  int i = task * S21_TRANSPOSE_STRIPE;
+  int m = job->m - i;
+  if (m > S21_TRANSPOSE_STRIPE) m = S21_TRANSPOSE_STRIPE;
+  s21_transpose_diag(job->a, i, m);
+  if (i + m < job->m) s21_transpose_swap(job->a, i, i + m, m, job->m - i - m);
+}
+
+/* results too big to stay cached are written around it */
+void s21_transpose_rows(double *const *a, int m, int n, double *const *b) {
+  if ((double)m * n < S21_TRANSPOSE_PARALLEL) {
+    s21_transpose_rec(a, 0, b, 0, m, n, FALSE);
+  } else {
+    s21_transpose_job_t job = {a, b, m, n, FALSE};
+    job.stream = (double)m * n >= S21_TRANSPOSE_STREAM;
+    int stripes = (m + S21_TRANSPOSE_STRIPE - 1) / S21_TRANSPOSE_STRIPE;
+    s21_parallel_for(stripes, s21_transpose_stripe, &job);
+  }
+}
+
+void s21_transpose_square(double **a, int n) {
+  if ((double)n * n < S21_TRANSPOSE_PARALLEL) {
+    s21_transpose_diag(a, 0, n);
+  } else {
+    s21_transpose_job_t job = {a, a, n, n, FALSE};
+    int stripes = (n + S21_TRANSPOSE_STRIPE - 1) / S21_TRANSPOSE_STRIPE;
+    s21_parallel_for(stripes, s21_transpose_square_stripe, &job);
+  }
+}
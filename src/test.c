@@ -1,4 +1,7 @@
 #include <check.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -43,6 +46,26 @@ START_TEST(create_mtrx) {
 }
 END_TEST
 
+START_TEST(create_mtrx_layout) {
+  matrix_t a;
+  ck_assert_int_eq(s21_create_matrix(5, 3, &a), OK);
+  ck_assert_int_eq((uintptr_t)a.matrix[0] % S21_ALIGN, 0);
+  for (int i = 1; i < a.rows; i++)
+    ck_assert_int_eq(a.matrix[i] - a.matrix[i - 1], 3);
+  s21_remove_matrix(&a);
+  ck_assert_int_eq(s21_create_matrix(5, 9, &a), OK);
+  for (int i = 0; i < a.rows; i++) {
+    ck_assert_int_eq((uintptr_t)a.matrix[i] % S21_ALIGN, 0);
+    if (i > 0) ck_assert_int_eq(a.matrix[i] - a.matrix[i - 1], 16);
+  }
+  ck_assert_int_eq(s21_leading_dim(1), 1);
+  ck_assert_int_eq(s21_leading_dim(7), 7);
+  ck_assert_int_eq(s21_leading_dim(8), 8);
+  ck_assert_int_eq(s21_leading_dim(9), 16);
+  s21_remove_matrix(&a);
+}
+END_TEST
+
 START_TEST(remove_mtrx) {
   matrix_t mtrx;
   s21_create_matrix(2, 2, &mtrx);
@@ -135,6 +158,61 @@ START_TEST(sub_mtrx) {
   ck_assert_int_eq(ERROR, err);
 }
 
+START_TEST(isa_levels) {
+  matrix_t a, b, result;
+  s21_create_matrix(3, 13, &a);
+  s21_create_matrix(3, 13, &b);
+  for (int i = 0; i < a.rows; i++) {
+    for (int j = 0; j < a.columns; j++) {
+      a.matrix[i][j] = i * 13 + j;
+      b.matrix[i][j] = j - i * 0.5;
+    }
+  }
+  /* large enough for the packed GEMM path, which follows the level too */
+  matrix_t p, q, product;
+  s21_create_matrix(60, 61, &p);
+  s21_create_matrix(61, 59, &q);
+  for (int i = 0; i < 61; i++) {
+    for (int j = 0; j < 59; j++) {
+      if (i < 60) p.matrix[i][j] = (i * 7 + j) % 11 - 5;
+      q.matrix[i][j] = (i + j * 3) % 9 - 4;
+    }
+    if (i < 60) p.matrix[i][59] = p.matrix[i][60] = i % 3;
+  }
+  int best = s21_set_isa_level(-1);
+  for (int level = S21_ISA_SCALAR; level <= S21_ISA_AVX512; level++) {
+    ck_assert_int_le(s21_set_isa_level(level), best);
+    ck_assert_int_eq(s21_mult_matrix(&p, &q, &product), OK);
+    for (int i = 0; i < 60; i += 7) {
+      for (int j = 0; j < 59; j += 5) {
+        double expected = 0;
+        for (int k = 0; k < 61; k++)
+          expected += p.matrix[i][k] * q.matrix[k][j];
+        ck_assert_double_eq(product.matrix[i][j], expected);
+      }
+    }
+    s21_remove_matrix(&product);
+    s21_sum_matrix(&a, &b, &result);
+    ck_assert_double_eq(result.matrix[2][12], 38 + 11);
+    s21_remove_matrix(&result);
+    s21_sub_matrix(&a, &b, &result);
+    ck_assert_double_eq(result.matrix[1][11], 13 + 11 - 10.5);
+    s21_remove_matrix(&result);
+    s21_mult_number(&a, -2, &result);
+    ck_assert_double_eq(result.matrix[2][10], -72);
+    ck_assert_int_eq(s21_eq_matrix(&a, &a), TRUE);
+    result.matrix[2][12] = a.matrix[2][12];
+    ck_assert_int_eq(s21_eq_matrix(&a, &result), FALSE);
+    s21_remove_matrix(&result);
+  }
+  ck_assert_int_eq(s21_set_isa_level(-1), best);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&p);
+  s21_remove_matrix(&q);
+}
+END_TEST
+
 START_TEST(mult_num) {
   matrix_t a, result, test;
   s21_create_matrix(3, 3, &a);
@@ -186,6 +264,669 @@ START_TEST(mult_mtrx) {
 }
 END_TEST
 
+START_TEST(mult_mtrx_blocked) {
+  matrix_t a, b, result, expected;
+  s21_create_matrix(101, 263, &a);
+  s21_create_matrix(263, 77, &b);
+  s21_create_matrix(101, 77, &expected);
+  for (int i = 0; i < a.rows; i++)
+    for (int j = 0; j < a.columns; j++) a.matrix[i][j] = (i * 7 + j) % 11 - 5;
+  for (int i = 0; i < b.rows; i++)
+    for (int j = 0; j < b.columns; j++) b.matrix[i][j] = (i + j * 3) % 13 - 6;
+  for (int i = 0; i < a.rows; i++)
+    for (int j = 0; j < b.columns; j++)
+      for (int r = 0; r < a.columns; r++)
+        expected.matrix[i][j] += a.matrix[i][r] * b.matrix[r][j];
+  ck_assert_int_eq(s21_mult_matrix(&a, &b, &result), OK);
+  ck_assert_int_eq(s21_eq_matrix(&result, &expected), TRUE);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&result);
+  s21_remove_matrix(&expected);
+}
+END_TEST
+
+START_TEST(mult_mtrx_threaded) {
+  matrix_t a, b, serial, threaded;
+  s21_create_matrix(300, 257, &a);
+  s21_create_matrix(257, 310, &b);
+  for (int i = 0; i < a.rows; i++)
+    for (int j = 0; j < a.columns; j++) a.matrix[i][j] = (i * 5 + j) % 9 - 4;
+  for (int i = 0; i < b.rows; i++)
+    for (int j = 0; j < b.columns; j++) b.matrix[i][j] = (i + j * 7) % 11 - 5;
+  s21_set_num_threads(1);
+  ck_assert_int_eq(s21_get_num_threads(), 1);
+  ck_assert_int_eq(s21_mult_matrix(&a, &b, &serial), OK);
+  s21_set_num_threads(4);
+  ck_assert_int_eq(s21_get_num_threads(), 4);
+  for (int pass = 0; pass < 3; pass++) {
+    ck_assert_int_eq(s21_mult_matrix(&a, &b, &threaded), OK);
+    ck_assert_int_eq(s21_eq_matrix(&threaded, &serial), TRUE);
+    s21_remove_matrix(&threaded);
+  }
+  s21_set_num_threads(0);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&serial);
+}
+END_TEST
+
+START_TEST(transpose_mtrx_large) {
+  matrix_t a, result, back;
+  s21_create_matrix(1031, 2050, &a);
+  for (int i = 0; i < a.rows; i++)
+    for (int j = 0; j < a.columns; j++) a.matrix[i][j] = i * 1000.0 + j;
+  for (int level = S21_ISA_SCALAR; level <= S21_ISA_AVX512; level++) {
+    s21_set_isa_level(level);
+    ck_assert_int_eq(s21_transpose(&a, &result), OK);
+    ck_assert_int_eq(result.rows, 2050);
+    ck_assert_int_eq(result.columns, 1031);
+    for (int i = 0; i < a.rows; i++)
+      for (int j = 0; j < a.columns; j++)
+        ck_assert_double_eq(result.matrix[j][i], a.matrix[i][j]);
+    ck_assert_int_eq(s21_transpose(&result, &back), OK);
+    ck_assert_int_eq(s21_eq_matrix(&back, &a), TRUE);
+    s21_remove_matrix(&result);
+    s21_remove_matrix(&back);
+  }
+  s21_set_isa_level(-1);
+  s21_remove_matrix(&a);
+}
+END_TEST
+
+START_TEST(transpose_inplace) {
+  matrix_t a, expected;
+  s21_create_matrix(1030, 1030, &a);
+  for (int i = 0; i < a.rows; i++)
+    for (int j = 0; j < a.columns; j++) a.matrix[i][j] = i * 2000.0 + j;
+  ck_assert_int_eq(s21_transpose(&a, &expected), OK);
+  ck_assert_int_eq(s21_transpose_inplace(&a), OK);
+  ck_assert_int_eq(s21_eq_matrix(&a, &expected), TRUE);
+  s21_set_num_threads(3);
+  ck_assert_int_eq(s21_transpose_inplace(&a), OK);
+  ck_assert_int_eq(s21_transpose_inplace(&expected), OK);
+  ck_assert_int_eq(s21_eq_matrix(&a, &expected), TRUE);
+  s21_set_num_threads(0);
+  s21_remove_matrix(&expected);
+  s21_create_matrix(2, 3, &expected);
+  ck_assert_int_eq(s21_transpose_inplace(&expected), CALCULATION_ERROR);
+  ck_assert_int_eq(s21_transpose_inplace(NULL), ERROR);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&expected);
+}
+END_TEST
+
+START_TEST(mult_mtrx_strassen) {
+  int dims[][3] = {{256, 256, 256}, {300, 300, 300}, {257, 301, 263}};
+  int cutoff = s21_strassen_cutoff();
+  if (!getenv("S21_STRASSEN_CUTOFF")) ck_assert_int_eq(cutoff, 128);
+  for (int t = 0; t < 3; t++) {
+    matrix_t a, b, plain, fast;
+    s21_create_matrix(dims[t][0], dims[t][1], &a);
+    s21_create_matrix(dims[t][1], dims[t][2], &b);
+    for (int i = 0; i < a.rows; i++)
+      for (int j = 0; j < a.columns; j++) a.matrix[i][j] = (i * 3 + j) % 7 - 3;
+    for (int i = 0; i < b.rows; i++)
+      for (int j = 0; j < b.columns; j++) b.matrix[i][j] = (i + j * 5) % 9 - 4;
+    s21_set_strassen_cutoff(0);
+    ck_assert_int_eq(s21_mult_matrix(&a, &b, &plain), OK);
+    s21_set_strassen_cutoff(1);
+    ck_assert_int_eq(s21_strassen_cutoff(), 64);
+    ck_assert_int_eq(s21_mult_matrix(&a, &b, &fast), OK);
+    ck_assert_int_eq(s21_eq_matrix(&fast, &plain), TRUE);
+    ck_assert_int_eq(s21_mult_matrix_into(&a, &b, &fast), OK);
+    ck_assert_int_eq(s21_eq_matrix(&fast, &plain), TRUE);
+    s21_set_strassen_cutoff(cutoff);
+    s21_remove_matrix(&a);
+    s21_remove_matrix(&b);
+    s21_remove_matrix(&plain);
+    s21_remove_matrix(&fast);
+  }
+}
+END_TEST
+
+START_TEST(mult_mtrx_batched) {
+  int sizes[] = {3, 4, 6, 5, 20}, counts[] = {1, 37, 5000};
+  for (int s = 0; s < 5; s++) {
+    for (int c = 0; c < 3; c++) {
+      int n = sizes[s], k = n == 5 ? 7 : n, count = counts[c];
+      matrix_t *a = calloc(count, sizeof(matrix_t));
+      matrix_t *b = calloc(count, sizeof(matrix_t));
+      matrix_t *r = calloc(count, sizeof(matrix_t));
+      for (int l = 0; l < count; l++) {
+        s21_create_matrix(n, k, &a[l]);
+        s21_create_matrix(k, n, &b[l]);
+        for (int i = 0; i < n; i++) {
+          for (int j = 0; j < k; j++) {
+            a[l].matrix[i][j] = (l + i * 3 + j) % 7 - 3;
+            b[l].matrix[j][i] = (l * 2 + i + j) % 5 - 2;
+          }
+        }
+      }
+      if (count > 1000) s21_set_num_threads(4);
+      ck_assert_int_eq(s21_mult_matrix_batched(a, b, r, count), OK);
+      s21_set_num_threads(0);
+      for (int l = 0; l < count; l++) {
+        matrix_t expected;
+        s21_mult_matrix(&a[l], &b[l], &expected);
+        ck_assert_int_eq(s21_eq_matrix(&r[l], &expected), TRUE);
+        s21_remove_matrix(&expected);
+        s21_remove_matrix(&a[l]);
+        s21_remove_matrix(&b[l]);
+        s21_remove_matrix(&r[l]);
+      }
+      free(a);
+      free(b);
+      free(r);
+    }
+  }
+  /* above the SoA limit the product must not clear an aliased operand */
+  for (int s = 0; s < 2; s++) {
+    matrix_t a[3], b[3], expected[3];
+    for (int l = 0; l < 3; l++) {
+      s21_create_matrix(20, 20, &a[l]);
+      s21_create_matrix(20, 20, &b[l]);
+      for (int i = 0; i < 20; i++) {
+        for (int j = 0; j < 20; j++) {
+          a[l].matrix[i][j] = (l + i * 3 + j) % 7 - 3;
+          b[l].matrix[i][j] = (l * 2 + i + j) % 5 - 2;
+        }
+      }
+      s21_mult_matrix(&a[l], &b[l], &expected[l]);
+    }
+    matrix_t *r = s ? b : a;
+    ck_assert_int_eq(s21_mult_matrix_batched(a, b, r, 3), OK);
+    for (int l = 0; l < 3; l++) {
+      ck_assert_int_eq(s21_eq_matrix(&r[l], &expected[l]), TRUE);
+      s21_remove_matrix(&a[l]);
+      s21_remove_matrix(&b[l]);
+      s21_remove_matrix(&expected[l]);
+    }
+  }
+}
+END_TEST
+
+START_TEST(mult_mtrx_strided) {
+  double a[5][12], b[9] = {1, 2, 3, 0, 1, 4, 5, 6, 0}, c[5][9];
+  for (int l = 0; l < 5; l++)
+    for (int e = 0; e < 9; e++) a[l][e] = l * 10 + e;
+  ck_assert_int_eq(s21_mult_matrix_strided(3, 3, 3, a[0], 12, b, 0, c[0], 9, 5),
+                   OK);
+  for (int l = 0; l < 5; l++)
+    for (int i = 0; i < 3; i++)
+      for (int j = 0; j < 3; j++) {
+        double expected = 0;
+        for (int p = 0; p < 3; p++) expected += a[l][i * 3 + p] * b[p * 3 + j];
+        ck_assert_double_eq(c[l][i * 3 + j], expected);
+      }
+  ck_assert_int_eq(s21_mult_matrix_strided(3, 3, 3, a[0], 12, b, 0, c[0], 8, 5),
+                   ERROR);
+  matrix_t x, y, z = {0};
+  s21_create_matrix(2, 3, &x);
+  s21_create_matrix(2, 3, &y);
+  ck_assert_int_eq(s21_mult_matrix_batched(&x, &y, &z, 1), CALCULATION_ERROR);
+  ck_assert_int_eq(s21_mult_matrix_batched(&x, &y, NULL, 1), ERROR);
+  s21_remove_matrix(&x);
+  s21_remove_matrix(&y);
+}
+END_TEST
+
+START_TEST(expr_chain) {
+  int shapes[][2] = {{3, 5}, {37, 1029}, {1100, 1000}};
+  s21_set_num_threads(4);
+  for (int s = 0; s < 3; s++) {
+    int rows = shapes[s][0], cols = shapes[s][1];
+    matrix_t a, b, c, d = {0}, t = {0}, expected = {0};
+    s21_create_matrix(rows, cols, &a);
+    s21_create_matrix(rows, cols, &b);
+    s21_create_matrix(rows, cols, &c);
+    for (int i = 0; i < rows; i++)
+      for (int j = 0; j < cols; j++) {
+        a.matrix[i][j] = i - j * 0.5;
+        b.matrix[i][j] = (i * 7 + j) % 13;
+        c.matrix[i][j] = j * 0.25;
+      }
+    s21_mult_number(&b, 2.0, &t);
+    s21_sum_matrix_into(&a, &t, &t);
+    s21_sub_matrix(&t, &c, &expected);
+
+    s21_expr_t *e = s21_expr_sub(
+        s21_expr_add(s21_expr_matrix(&a),
+                     s21_expr_scale(s21_expr_matrix(&b), 2.0)),
+        s21_expr_matrix(&c));
+    ck_assert_int_eq(s21_expr_eval(e, &d), OK);
+    ck_assert_int_eq(s21_eq_matrix(&d, &expected), TRUE);
+    ck_assert_int_eq(s21_expr_eval(e, &b), OK);
+    ck_assert_int_eq(s21_eq_matrix(&b, &expected), TRUE);
+    s21_expr_free(e);
+
+    e = s21_expr_add(s21_expr_matrix(&a), s21_expr_matrix(&a));
+    e = s21_expr_sub(e, s21_expr_scale(s21_expr_matrix(&a), 3.0));
+    ck_assert_int_eq(s21_expr_eval(e, &a), OK);
+    ck_assert_double_eq(a.matrix[rows - 1][cols - 1],
+                        -(rows - 1 - (cols - 1) * 0.5));
+    s21_expr_free(e);
+    s21_remove_matrix(&a);
+    s21_remove_matrix(&b);
+    s21_remove_matrix(&c);
+    s21_remove_matrix(&d);
+    s21_remove_matrix(&t);
+    s21_remove_matrix(&expected);
+  }
+  s21_set_num_threads(0);
+
+  matrix_t x, y, z = {0};
+  s21_create_matrix(2, 3, &x);
+  s21_create_matrix(3, 2, &y);
+  s21_expr_t *e = s21_expr_add(s21_expr_matrix(&x), s21_expr_matrix(&y));
+  ck_assert_int_eq(s21_expr_eval(e, &z), CALCULATION_ERROR);
+  s21_expr_free(e);
+  e = s21_expr_add(s21_expr_matrix(&x), s21_expr_matrix(&z));
+  ck_assert_int_eq(s21_expr_eval(e, &z), ERROR);
+  ck_assert_int_eq(s21_expr_eval(e, NULL), ERROR);
+  ck_assert_int_eq(s21_expr_eval(NULL, &z), ERROR);
+  s21_expr_free(e);
+  e = s21_expr_matrix(&x);
+  ck_assert_ptr_eq(s21_expr_sub(e, e), e);
+  ck_assert_int_eq(s21_expr_eval(e, &z), OK);
+  ck_assert_double_eq(z.matrix[1][2], 0.0);
+  s21_expr_free(e);
+  s21_remove_matrix(&x);
+  s21_remove_matrix(&y);
+  s21_remove_matrix(&z);
+}
+END_TEST
+
+static void *stats_worker(void *a) {
+  double det = 0.0;
+  s21_determinant(a, &det);
+  return NULL;
+}
+
+START_TEST(stats_counters) {
+  s21_stats_t s[S21_STATS_COUNT];
+  matrix_t a = {0}, b = {0}, c = {0};
+  s21_stats_reset();
+  s21_create_matrix(40, 40, &a);
+  s21_create_matrix(40, 40, &b);
+  for (int i = 0; i < 40; i++) a.matrix[i][i] = b.matrix[i][i] = 2.0;
+  ck_assert_int_eq(s21_sum_matrix(&a, &b, &c), OK);
+  s21_remove_matrix(&c);
+  ck_assert_int_eq(s21_inverse_matrix(&a, &c), OK);
+  s21_remove_matrix(&c);
+  pthread_t worker;
+  pthread_create(&worker, NULL, stats_worker, &a);
+  pthread_join(worker, NULL);
+  ck_assert_int_eq(s21_stats_snapshot(s), OK);
+  if (s21_stats_enabled()) {
+    ck_assert_uint_eq(s[S21_STATS_CREATE_MATRIX].calls, 2);
+    ck_assert_uint_eq(s[S21_STATS_REMOVE_MATRIX].calls, 2);
+    ck_assert_uint_eq(s[S21_STATS_SUM_MATRIX].calls, 1);
+    ck_assert_uint_eq(s[S21_STATS_SUM_MATRIX].flops, 1600);
+    ck_assert(s[S21_STATS_SUM_MATRIX].bytes_allocated >= 1600 * 8);
+    ck_assert_uint_eq(s[S21_STATS_SUM_MATRIX].temporaries, 0);
+    ck_assert_uint_eq(s[S21_STATS_INVERSE_MATRIX].calls, 1);
+    /* 2I is SPD, so the inverse goes through Cholesky */
+    ck_assert_uint_eq(s[S21_STATS_INVERSE_MATRIX].flops, 40 * 40 * 40);
+    ck_assert(s[S21_STATS_INVERSE_MATRIX].temporaries > 0);
+    ck_assert(s[S21_STATS_INVERSE_MATRIX].nanoseconds > 0);
+    ck_assert_uint_eq(s[S21_STATS_DETERMINANT].calls, 1);
+    s21_stats_reset();
+    s21_stats_snapshot(s);
+  }
+  for (int f = 0; f < S21_STATS_COUNT; f++) {
+    ck_assert_uint_eq(s[f].calls + s[f].flops + s[f].bytes_allocated +
+                          s[f].temporaries + s[f].nanoseconds,
+                      0);
+  }
+  ck_assert_int_eq(s21_stats_snapshot(NULL), ERROR);
+  ck_assert_int_eq(strcmp(s21_stats_name(S21_STATS_EXPR_EVAL),
+                          "s21_expr_eval"),
+                   0);
+  ck_assert_ptr_null(s21_stats_name(S21_STATS_COUNT));
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+}
+END_TEST
+
+static void flip_byte(const char *path, long offset) {
+  FILE *f = fopen(path, "r+b");
+  fseek(f, offset, SEEK_SET);
+  int c = fgetc(f);
+  fseek(f, offset, SEEK_SET);
+  fputc(c ^ 1, f);
+  fclose(f);
+}
+
+START_TEST(matrix_file) {
+  const char *path = "s21_test_matrix.s21";
+  matrix_t a = {0}, mapped = {0}, sum = {0};
+  s21_create_matrix(37, 53, &a);
+  for (int i = 0; i < 37; i++)
+    for (int j = 0; j < 53; j++) a.matrix[i][j] = i * 0.5 - j / 3.0;
+  ck_assert_int_eq(s21_matrix_save(&a, path), OK);
+  ck_assert_int_eq(s21_matrix_verify(path), OK);
+  ck_assert_int_eq(s21_matrix_mmap(path, &mapped), OK);
+  ck_assert_int_eq(s21_eq_matrix(&a, &mapped), TRUE);
+  ck_assert_int_eq((uintptr_t)mapped.matrix[36] % S21_ALIGN, 0);
+  ck_assert_int_eq(s21_sum_matrix(&mapped, &a, &sum), OK);
+  ck_assert_double_eq(sum.matrix[36][52], 2 * a.matrix[36][52]);
+  /* there is no block behind a mapped row table to reuse */
+  matrix_t small = {0};
+  s21_create_matrix(5, 5, &small);
+  ck_assert_int_eq(s21_mult_number_into(&small, 2.0, &mapped), ERROR);
+  ck_assert_int_eq(s21_sum_matrix_into(&a, &a, &mapped), ERROR);
+  ck_assert_int_eq(s21_eq_matrix(&a, &mapped), TRUE);
+  s21_remove_matrix(&small);
+  s21_remove_matrix(&mapped);
+  ck_assert_ptr_null(mapped.matrix);
+
+  flip_byte(path, 64 + 8 * 100);
+  ck_assert_int_eq(s21_matrix_verify(path), CALCULATION_ERROR);
+  ck_assert_int_eq(s21_matrix_mmap(path, &mapped), OK);
+  s21_remove_matrix(&mapped);
+  flip_byte(path, 20);
+  ck_assert_int_eq(s21_matrix_mmap(path, &mapped), ERROR);
+  ck_assert_int_eq(s21_matrix_verify(path), ERROR);
+  remove(path);
+  ck_assert_int_eq(s21_matrix_mmap(path, &mapped), ERROR);
+  ck_assert_int_eq(s21_matrix_save(&mapped, path), ERROR);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&sum);
+}
+END_TEST
+
+START_TEST(mult_matrix_file) {
+  const char *paths[] = {"s21_test_a.s21", "s21_test_b.s21",
+                         "s21_test_c.s21"};
+  matrix_t a = {0}, b = {0}, expected = {0}, c = {0};
+  s21_create_matrix(50, 70, &a);
+  s21_create_matrix(70, 41, &b);
+  for (int i = 0; i < 50; i++)
+    for (int j = 0; j < 70; j++) a.matrix[i][j] = (i * 7 + j) % 13 - 6.0;
+  for (int i = 0; i < 70; i++)
+    for (int j = 0; j < 41; j++) b.matrix[i][j] = (i + 3 * j) % 9 / 4.0;
+  s21_mult_matrix(&a, &b, &expected);
+  s21_matrix_save(&a, paths[0]);
+  s21_matrix_save(&b, paths[1]);
+  size_t budgets[] = {4096, 100000, 1 << 20};
+  for (int t = 0; t < 3; t++) {
+    ck_assert_int_eq(
+        s21_mult_matrix_file(paths[0], paths[1], paths[2], budgets[t]), OK);
+    ck_assert_int_eq(s21_matrix_verify(paths[2]), OK);
+    ck_assert_int_eq(s21_matrix_mmap(paths[2], &c), OK);
+    ck_assert_int_eq(s21_eq_matrix(&c, &expected), TRUE);
+    s21_remove_matrix(&c);
+  }
+  remove(paths[2]);
+  ck_assert_int_eq(s21_mult_matrix_file(paths[0], paths[1], paths[2], 1000),
+                   ERROR);
+  ck_assert_int_eq(s21_matrix_mmap(paths[2], &c), ERROR);
+  ck_assert_int_eq(s21_mult_matrix_file(paths[1], paths[1], paths[2], 1 << 20),
+                   CALCULATION_ERROR);
+  ck_assert_int_eq(s21_mult_matrix_file(paths[2], paths[1], paths[2], 1 << 20),
+                   ERROR);
+  remove(paths[0]);
+  remove(paths[1]);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&expected);
+}
+END_TEST
+
+static void sparse_pattern(matrix_t *a, int rows, int columns, int percent) {
+  s21_create_matrix(rows, columns, a);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < columns; j++)
+      if ((i * 31 + j * 17) % 100 < percent)
+        a->matrix[i][j] = (i - j) % 7 + 0.5;
+}
+
+START_TEST(sparse_matrix) {
+  matrix_t a = {0}, b = {0}, x = {0}, dense = {0}, got = {0}, sum = {0};
+  s21_sparse_t csr = {0}, csc = {0}, r = {0};
+  sparse_pattern(&a, 1200, 1000, 8);
+  sparse_pattern(&b, 1200, 1000, 3);
+  sparse_pattern(&x, 1000, 40, 60);
+  double *v = malloc(sizeof(double) * 1000), *y = malloc(sizeof(double) * 1200);
+  for (int j = 0; j < 1000; j++) v[j] = x.matrix[j][0];
+  s21_set_num_threads(4);
+  ck_assert_int_eq(s21_sparse_from_matrix(&a, S21_SPARSE_CSR, &csr), OK);
+  ck_assert_int_eq(s21_sparse_from_matrix(&a, S21_SPARSE_CSC, &csc), OK);
+  ck_assert_uint_eq(csr.nnz, csc.nnz);
+  ck_assert_uint_eq(csr.ptr[1200], csr.nnz);
+  ck_assert_int_eq(s21_sparse_to_matrix(&csc, &got), OK);
+  ck_assert_int_eq(s21_eq_matrix(&a, &got), TRUE);
+  s21_remove_matrix(&got);
+  ck_assert_int_eq(s21_sparse_convert(&csc, S21_SPARSE_CSR, &csc), OK);
+  ck_assert_int_eq(memcmp(csc.index, csr.index, sizeof(int) * csr.nnz), 0);
+  ck_assert_int_eq(s21_sparse_convert(&csc, S21_SPARSE_CSC, &csc), OK);
+
+  s21_mult_matrix(&a, &x, &dense);
+  for (int f = 0; f < 2; f++) {
+    s21_sparse_t *s = f ? &csc : &csr;
+    ck_assert_int_eq(s21_sparse_mult_vector(s, v, y), OK);
+    for (int i = 0; i < 1200; i++)
+      ck_assert_double_eq_tol(y[i], dense.matrix[i][0], 1e-9);
+    ck_assert_int_eq(s21_sparse_mult_matrix(s, &x, &got), OK);
+    ck_assert_int_eq(s21_eq_matrix(&got, &dense), TRUE);
+    s21_remove_matrix(&got);
+  }
+  s21_set_num_threads(0);
+
+  s21_sum_matrix(&a, &b, &sum);
+  s21_sparse_free(&csc);
+  s21_sparse_from_matrix(&b, S21_SPARSE_CSC, &csc);
+  ck_assert_int_eq(s21_sparse_sum(&csr, &csc, &r), OK);
+  ck_assert_int_eq(r.format, S21_SPARSE_CSR);
+  ck_assert_int_eq(s21_sparse_mult_number(&r, -2.0, &r), OK);
+  s21_sparse_free(&csr);
+  ck_assert_int_eq(s21_sparse_mult_number(&r, -0.5, &csr), OK);
+  s21_sparse_to_matrix(&csr, &got);
+  ck_assert_int_eq(s21_eq_matrix(&got, &sum), TRUE);
+  s21_remove_matrix(&got);
+  s21_sparse_t neg = {0};
+  ck_assert_int_eq(s21_sparse_mult_number(&csr, -1.0, &neg), OK);
+  ck_assert_int_eq(s21_sparse_sum(&neg, &csr, &neg), OK);
+  ck_assert_uint_eq(neg.nnz, 0);
+  ck_assert_uint_eq(neg.ptr[1200], 0);
+  s21_sparse_free(&neg);
+
+  ck_assert_int_eq(s21_sparse_mult_matrix(&csr, &a, &got), CALCULATION_ERROR);
+  ck_assert_int_eq(s21_sparse_sum(&csr, &r, NULL), ERROR);
+  ck_assert_int_eq(s21_sparse_mult_vector(NULL, v, y), ERROR);
+  ck_assert_int_eq(s21_sparse_from_matrix(&a, 2, &r), ERROR);
+  ck_assert_int_eq(s21_sparse_create(2, 2, 5, S21_SPARSE_CSR, &r), ERROR);
+  s21_sparse_free(&csr);
+  s21_sparse_free(&csc);
+  s21_sparse_free(&r);
+  s21_sparse_create(3, 4, 0, S21_SPARSE_CSC, &r);
+  ck_assert_int_eq(s21_sparse_to_matrix(&r, &got), OK);
+  ck_assert_double_eq(got.matrix[2][3], 0.0);
+  s21_sparse_free(&r);
+  free(v);
+  free(y);
+  s21_remove_matrix(&got);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&x);
+  s21_remove_matrix(&dense);
+  s21_remove_matrix(&sum);
+}
+END_TEST
+
+/* b b^T / n + shift * I, exactly symmetric */
+static void spd_matrix(matrix_t *a, int n, double shift) {
+  s21_create_matrix(n, n, a);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j <= i; j++) {
+      double s = 0.0;
+      for (int k = 0; k < n; k++)
+        s += ((i * 7 + k * 3) % 11 - 5.0) * ((j * 7 + k * 3) % 11 - 5.0);
+      a->matrix[i][j] = a->matrix[j][i] = s / n + (i == j) * shift;
+    }
+  }
+}
+
+START_TEST(cholesky_spd) {
+  int n = 150;
+  matrix_t a = {0}, l = {0}, lt = {0}, llt = {0}, b = {0}, x = {0};
+  matrix_t ax = {0}, inv = {0}, inv_lu = {0}, in_place = {0};
+  spd_matrix(&a, n, 1.0);
+  ck_assert_int_eq(s21_cholesky(&a, &l), OK);
+  ck_assert_double_eq(l.matrix[0][n - 1], 0.0);
+  s21_transpose(&l, &lt);
+  s21_mult_matrix(&l, &lt, &llt);
+  ck_assert_int_eq(s21_eq_matrix(&llt, &a), TRUE);
+
+  s21_create_matrix(n, 5, &b);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < 5; j++) b.matrix[i][j] = (i + j) % 4 - 1.5;
+  s21_stats_reset();
+  ck_assert_int_eq(s21_cholesky_solve(&l, &b, &x), OK);
+  s21_stats_t s[S21_STATS_COUNT];
+  s21_stats_snapshot(s);
+  if (s21_stats_enabled()) {
+    ck_assert_uint_eq(s[S21_STATS_SOLVE].calls, 1);
+    ck_assert_uint_eq(s[S21_STATS_SOLVE].flops, 2 * n * n * 5);
+  }
+  s21_mult_matrix(&a, &x, &ax);
+  ck_assert_int_eq(s21_eq_matrix(&ax, &b), TRUE);
+
+  double det = 0.0, det_lu = 0.0;
+  s21_set_spd_detection(TRUE);
+  ck_assert_int_eq(s21_spd_detection(), TRUE);
+  ck_assert_int_eq(s21_determinant(&a, &det), OK);
+  ck_assert_int_eq(s21_inverse_matrix(&a, &inv), OK);
+  s21_mult_number(&a, 1.0, &in_place);
+  ck_assert_int_eq(s21_inverse_matrix_into(&in_place, &in_place), OK);
+  s21_set_spd_detection(FALSE);
+  ck_assert_int_eq(s21_determinant(&a, &det_lu), OK);
+  ck_assert_int_eq(s21_inverse_matrix(&a, &inv_lu), OK);
+  s21_set_spd_detection(TRUE);
+  ck_assert_double_eq_tol(det, det_lu, 1e-9 * fabs(det_lu));
+  ck_assert_int_eq(s21_eq_matrix(&inv, &inv_lu), TRUE);
+  ck_assert_int_eq(s21_eq_matrix(&in_place, &inv_lu), TRUE);
+  s21_remove_matrix(&inv);
+  s21_remove_matrix(&inv_lu);
+  s21_remove_matrix(&l);
+
+  /* symmetric but indefinite: LU takes over */
+  a.matrix[n / 2][n / 2] = -50.0;
+  ck_assert_int_eq(s21_cholesky(&a, &l), CALCULATION_ERROR);
+  ck_assert_int_eq(s21_inverse_matrix(&a, &inv), OK);
+  s21_remove_matrix(&llt);
+  s21_mult_matrix(&a, &inv, &llt);
+  for (int i = 0; i < n; i++)
+    ck_assert_double_eq_tol(llt.matrix[i][i], 1.0, 1e-9);
+  ck_assert_int_eq(s21_cholesky(&b, &l), CALCULATION_ERROR);
+  ck_assert_int_eq(s21_cholesky(NULL, &l), ERROR);
+  ck_assert_int_eq(s21_cholesky_solve(&lt, &ax, NULL), ERROR);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&lt);
+  s21_remove_matrix(&llt);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&x);
+  s21_remove_matrix(&ax);
+  s21_remove_matrix(&inv);
+  s21_remove_matrix(&in_place);
+}
+END_TEST
+
+START_TEST(solve_system) {
+  int sizes[] = {1, 7, 90, 200}, columns[] = {1, 3, 17, 300};
+  for (int s = 0; s < 4; s++) {
+    int n = sizes[s], m = columns[s];
+    matrix_t a = {0}, b = {0}, x = {0}, ax = {0};
+    s21_create_matrix(n, n, &a);
+    s21_create_matrix(n, m, &b);
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++)
+        a.matrix[i][j] = ((i * 5 + j * 3) % 13 - 6) / 7.0 + (i == j) * 3;
+      for (int j = 0; j < m; j++) b.matrix[i][j] = (i + 2 * j) % 5 - 2.0;
+    }
+    if (s == 3) s21_set_num_threads(4);
+    ck_assert_int_eq(s21_solve(&a, &b, &x), OK);
+    s21_set_num_threads(0);
+    s21_mult_matrix(&a, &x, &ax);
+    ck_assert_int_eq(s21_eq_matrix(&ax, &b), TRUE);
+    s21_remove_matrix(&x);
+    s21_remove_matrix(&ax);
+    s21_remove_matrix(&a);
+    s21_remove_matrix(&b);
+  }
+
+  matrix_t a = {0}, b = {0}, x = {0}, ax = {0};
+  spd_matrix(&a, 70, 0.5);
+  s21_create_matrix(70, 2, &b);
+  for (int i = 0; i < 70; i++) b.matrix[i][i % 2] = 1.0;
+  ck_assert_int_eq(s21_solve(&a, &b, &x), OK);
+  s21_mult_matrix(&a, &x, &ax);
+  ck_assert_int_eq(s21_eq_matrix(&ax, &b), TRUE);
+  s21_remove_matrix(&x);
+  for (int j = 0; j < 70; j++) a.matrix[69][j] = a.matrix[3][j];
+  ck_assert_int_eq(s21_solve(&a, &b, &x), CALCULATION_ERROR);
+  ck_assert_int_eq(s21_solve(&b, &b, &x), CALCULATION_ERROR);
+  ck_assert_int_eq(s21_solve(&a, NULL, &x), ERROR);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&ax);
+}
+END_TEST
+
+START_TEST(det_inverse_batched) {
+  int sizes[] = {1, 2, 3, 4, 5, 9, 16, 17};
+  for (int s = 0; s < 8; s++) {
+    int n = sizes[s], count = s == 2 ? 2000 : 37;
+    matrix_t *a = calloc(count, sizeof(matrix_t));
+    matrix_t *inv = calloc(count, sizeof(matrix_t));
+    double *det = calloc(count, sizeof(double));
+    int *singular = calloc(count, sizeof(int));
+    for (int l = 0; l < count; l++) {
+      s21_create_matrix(n, n, &a[l]);
+      for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+          a[l].matrix[i][j] = ((l + 3 * i + 7 * j) % 11 - 5) / 4.0 + (i == j);
+      if (l % 5 == 4)
+        for (int j = 0; j < n; j++) a[l].matrix[n - 1][j] = a[l].matrix[0][j];
+    }
+    if (count > 1000) s21_set_num_threads(4);
+    ck_assert_int_eq(s21_determinant_batched(a, det, singular, count), OK);
+    ck_assert_int_eq(s21_inverse_batched(a, inv, NULL, count), OK);
+    s21_set_num_threads(0);
+    for (int l = 0; l < count; l++) {
+      matrix_t expected = {0};
+      double d = 0.0;
+      s21_determinant(&a[l], &d);
+      int err = s21_inverse_matrix(&a[l], &expected);
+      ck_assert_int_eq(singular[l], err != OK);
+      if (err == OK) {
+        ck_assert_double_eq_tol(det[l], d, 1e-9 * (fabs(d) + 1));
+        ck_assert_int_eq(s21_eq_matrix(&inv[l], &expected), TRUE);
+      } else {
+        ck_assert_double_eq(det[l], 0.0);
+        for (int i = 0; i < n; i++)
+          for (int j = 0; j < n; j++)
+            ck_assert_double_eq(inv[l].matrix[i][j], 0.0);
+      }
+      s21_remove_matrix(&expected);
+      s21_remove_matrix(&a[l]);
+      s21_remove_matrix(&inv[l]);
+    }
+    free(a);
+    free(inv);
+    free(det);
+    free(singular);
+  }
+  matrix_t x;
+  double d;
+  s21_create_matrix(2, 3, &x);
+  ck_assert_int_eq(s21_determinant_batched(&x, &d, NULL, 1), CALCULATION_ERROR);
+  ck_assert_int_eq(s21_inverse_batched(&x, NULL, NULL, 1), ERROR);
+  s21_remove_matrix(&x);
+}
+END_TEST
+
 START_TEST(mult_err_mtrx) {
   matrix_t a, b, result;
   s21_create_matrix(3, 3, &a);
@@ -199,6 +940,119 @@ START_TEST(mult_err_mtrx) {
 }
 END_TEST
 
+START_TEST(into_reuses_storage) {
+  matrix_t a, b, result = {0};
+  s21_create_matrix(3, 3, &a);
+  s21_create_matrix(3, 3, &b);
+  s21_fill_matrix(&a,
+                  "1 2 3 "
+                  "4 5 6 "
+                  "7 8 10 ");
+  s21_fill_matrix(&b,
+                  "1 0 0 "
+                  "0 2 0 "
+                  "0 0 3 ");
+  ck_assert_int_eq(s21_sum_matrix_into(&a, &b, &result), OK);
+  double **storage = result.matrix;
+  ck_assert_double_eq(result.matrix[2][2], 13);
+  ck_assert_int_eq(s21_mult_matrix_into(&a, &b, &result), OK);
+  ck_assert_ptr_eq(result.matrix, storage);
+  ck_assert_double_eq(result.matrix[1][2], 18);
+  ck_assert_int_eq(s21_inverse_matrix_into(&b, &result), OK);
+  ck_assert_ptr_eq(result.matrix, storage);
+  ck_assert_double_eq_tol(result.matrix[1][1], 0.5, 1e-12);
+  ck_assert_double_eq(result.matrix[0][1], 0);
+  ck_assert_int_eq(s21_calc_complements_into(&a, &result), OK);
+  ck_assert_ptr_eq(result.matrix, storage);
+  ck_assert_double_eq_tol(result.matrix[2][2], -3, 1e-12);
+  matrix_t row = {0};
+  s21_create_matrix(1, 2, &row);
+  ck_assert_int_eq(s21_transpose_into(&row, &result), OK);
+  ck_assert_ptr_eq(result.matrix, storage);
+  ck_assert_int_eq(result.rows, 2);
+  ck_assert_int_eq(result.columns, 1);
+  s21_remove_matrix(&row);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&result);
+}
+END_TEST
+
+START_TEST(into_aliasing) {
+  matrix_t a, b, expected;
+  s21_create_matrix(2, 3, &a);
+  s21_create_matrix(3, 2, &b);
+  s21_create_matrix(2, 2, &expected);
+  s21_fill_matrix(&a,
+                  "1 2 3 "
+                  "4 5 6 ");
+  s21_fill_matrix(&b,
+                  "1 2 "
+                  "3 4 "
+                  "5 6 ");
+  s21_fill_matrix(&expected,
+                  "22 28 "
+                  "49 64 ");
+  ck_assert_int_eq(s21_mult_matrix_into(&a, &b, &a), OK);
+  ck_assert_int_eq(s21_eq_matrix(&a, &expected), TRUE);
+  ck_assert_int_eq(s21_sum_matrix_into(&a, &a, &a), OK);
+  ck_assert_int_eq(s21_mult_number_into(&a, 0.5, &a), OK);
+  ck_assert_int_eq(s21_eq_matrix(&a, &expected), TRUE);
+  ck_assert_int_eq(s21_transpose_into(&a, &a), OK);
+  ck_assert_double_eq(a.matrix[0][1], 49);
+  ck_assert_int_eq(s21_transpose_into(&b, &b), OK);
+  ck_assert_int_eq(b.rows, 2);
+  ck_assert_double_eq(b.matrix[1][2], 6);
+  ck_assert_int_eq(s21_sub_matrix_into(&a, &a, &a), OK);
+  ck_assert_double_eq(a.matrix[1][0], 0);
+  ck_assert_int_eq(s21_sum_matrix_into(&a, &b, &a), CALCULATION_ERROR);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&expected);
+}
+END_TEST
+
+/* with a chunk of its own, so the caller's arena is not the only one */
+static void *arena_remover(void *m) {
+  matrix_t a;
+  double det = 0;
+  s21_create_matrix(20, 20, &a);
+  s21_determinant(&a, &det);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(m);
+  return NULL;
+}
+
+START_TEST(arena_scope) {
+  matrix_t a, t;
+  double det = 0;
+  s21_create_matrix(20, 20, &a);
+  for (int i = 0; i < a.rows; i++) a.matrix[i][i] = 2;
+  s21_determinant(&a, &det);
+  size_t chunks = s21_arena_chunks_allocated();
+  for (int k = 0; k < 100; k++) s21_determinant(&a, &det);
+  ck_assert_double_eq_tol(det, 1048576, 1e-6);
+  ck_assert_int_eq(s21_arena_chunks_allocated(), chunks);
+
+  s21_arena_mark_t mark = s21_arena_begin();
+  double *first = s21_arena_alloc(100);
+  ck_assert_int_eq((uintptr_t)first % S21_ALIGN, 0);
+  ck_assert_int_eq(s21_arena_create_matrix(3, 3, &t), OK);
+  ck_assert_double_eq(t.matrix[2][2], 0);
+  s21_remove_matrix(&t);
+  ck_assert_ptr_null(t.matrix);
+  ck_assert_int_eq(s21_arena_create_matrix(3, 3, &t), OK);
+  pthread_t worker;
+  pthread_create(&worker, NULL, arena_remover, &t);
+  pthread_join(worker, NULL);
+  ck_assert_ptr_null(t.matrix);
+  s21_arena_end(mark);
+  ck_assert_ptr_eq(s21_arena_alloc(8), first);
+  s21_arena_end(mark);
+  s21_remove_matrix(&a);
+}
+END_TEST
+
 START_TEST(mtrx_det) {
   matrix_t a, b;
   double result, test = 1;
@@ -306,6 +1160,35 @@ START_TEST(complem_mtrx_1x1) {
   s21_remove_matrix(&test);
 }
 
+START_TEST(complem_mtrx_singular) {
+  matrix_t a, result, expected;
+  s21_create_matrix(3, 3, &a);
+  s21_create_matrix(3, 3, &expected);
+  s21_fill_matrix(&a,
+                  "1 2 3 "
+                  "4 5 6 "
+                  "7 8 9 ");
+  s21_fill_matrix(&expected,
+                  "-3   6 -3 "
+                  " 6 -12  6 "
+                  "-3   6 -3 ");
+  ck_assert_int_eq(s21_calc_complements(&a, &result), OK);
+  ck_assert_int_eq(s21_eq_matrix(&result, &expected), TRUE);
+  s21_remove_matrix(&result);
+  s21_remove_matrix(&expected);
+  s21_fill_matrix(&a,
+                  "1 2 3 "
+                  "2 4 6 "
+                  "3 6 9 ");
+  s21_create_matrix(3, 3, &expected);
+  ck_assert_int_eq(s21_calc_complements(&a, &result), OK);
+  ck_assert_int_eq(s21_eq_matrix(&result, &expected), TRUE);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&result);
+  s21_remove_matrix(&expected);
+}
+END_TEST
+
 START_TEST(complem_invalid_input) {
   matrix_t A = {0};
   int err = s21_calc_complements(&A, NULL);
@@ -349,6 +1232,98 @@ START_TEST(s21_calc_complements_3) {
 }
 END_TEST
 
+START_TEST(lu_reuse) {
+  matrix_t a, b, x, check;
+  s21_lu_t *lu = NULL;
+  double det = 0, v[3] = {1, 2, 3}, y[3];
+  s21_create_matrix(3, 3, &a);
+  s21_create_matrix(3, 2, &b);
+  s21_fill_matrix(&a,
+                  "2 5 7 "
+                  "6 3 4 "
+                  "5 -2 -3 ");
+  s21_fill_matrix(&b,
+                  "1 0 "
+                  "2 1 "
+                  "3 0 ");
+  ck_assert_int_eq(s21_lu_factor(&a, &lu), OK);
+  ck_assert_int_eq(s21_lu_det(lu, &det), OK);
+  ck_assert_double_eq_tol(det, -1, 1e-9);
+  ck_assert_int_eq(s21_lu_solve(lu, &b, &x), OK);
+  s21_mult_matrix(&a, &x, &check);
+  ck_assert_int_eq(s21_eq_matrix(&check, &b), TRUE);
+  ck_assert_int_eq(s21_lu_solve_vector(lu, v, y), OK);
+  for (int i = 0; i < 3; i++) {
+    double s = 0;
+    for (int j = 0; j < 3; j++) s += a.matrix[i][j] * y[j];
+    ck_assert_double_eq_tol(s, v[i], 1e-9);
+  }
+  s21_remove_matrix(&x);
+  s21_remove_matrix(&check);
+  ck_assert_int_eq(s21_lu_inverse(lu, &x), OK);
+  ck_assert_double_eq_tol(x.matrix[0][0], 1, 1e-9);
+  ck_assert_double_eq_tol(x.matrix[2][2], 24, 1e-9);
+  s21_lu_free(lu);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&x);
+}
+END_TEST
+
+/* 4000 rounds would leave about 10 MB of scratch behind without a scope */
+START_TEST(lu_arena_scope) {
+  matrix_t a, b, x;
+  s21_lu_t *lu = NULL;
+  s21_create_matrix(64, 64, &a);
+  s21_create_matrix(64, 1, &b);
+  for (int i = 0; i < a.rows; i++) {
+    a.matrix[i][i] = 4;
+    a.matrix[i][(i + 1) % a.columns] = 1;
+    b.matrix[i][0] = i;
+  }
+  s21_arena_release();
+  size_t chunks = 0;
+  for (int k = 0; k < 4000; k++) {
+    ck_assert_int_eq(s21_lu_factor(&a, &lu), OK);
+    ck_assert_int_eq(s21_lu_solve(lu, &b, &x), OK);
+    s21_remove_matrix(&x);
+    ck_assert_int_eq(s21_lu_inverse(lu, &x), OK);
+    s21_remove_matrix(&x);
+    s21_lu_free(lu);
+    if (!k) chunks = s21_arena_chunks_allocated();
+  }
+  ck_assert_int_eq(s21_arena_chunks_allocated(), chunks);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+}
+END_TEST
+
+START_TEST(lu_singular) {
+  matrix_t a, b, x;
+  s21_lu_t *lu = NULL;
+  double det = 1;
+  s21_create_matrix(3, 3, &a);
+  s21_create_matrix(3, 1, &b);
+  s21_fill_matrix(&a,
+                  "1 2 3 "
+                  "4 5 6 "
+                  "7 8 9 ");
+  ck_assert_int_eq(s21_lu_factor(&a, &lu), OK);
+  ck_assert_int_eq(s21_lu_det(lu, &det), OK);
+  ck_assert_double_eq(det, 0);
+  ck_assert_int_eq(s21_lu_solve(lu, &b, &x), CALCULATION_ERROR);
+  ck_assert_int_eq(s21_lu_inverse(lu, &x), CALCULATION_ERROR);
+  s21_lu_free(lu);
+  s21_remove_matrix(&b);
+  s21_create_matrix(3, 2, &b);
+  ck_assert_int_eq(s21_lu_factor(&b, &lu), CALCULATION_ERROR);
+  ck_assert_ptr_null(lu);
+  ck_assert_int_eq(s21_lu_det(NULL, &det), ERROR);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+}
+END_TEST
+
 START_TEST(inverse_mtrx) {
   matrix_t a, test, inv, nonsquare;
   s21_create_matrix(2, 1, &nonsquare);
@@ -375,6 +1350,27 @@ START_TEST(inverse_mtrx) {
 }
 END_TEST
 
+START_TEST(inverse_mtrx_large) {
+  matrix_t a, inv, product, eye;
+  s21_create_matrix(150, 150, &a);
+  s21_create_matrix(150, 150, &eye);
+  for (int i = 0; i < a.rows; i++) {
+    eye.matrix[i][i] = 1.0;
+    for (int j = 0; j < a.columns; j++)
+      a.matrix[i][j] = (i * 31 + j * 17) % 23 + (i == j) * 500.0;
+  }
+  ck_assert_int_eq(s21_inverse_matrix(&a, &inv), OK);
+  s21_mult_matrix(&a, &inv, &product);
+  ck_assert_int_eq(s21_eq_matrix(&product, &eye), TRUE);
+  s21_remove_matrix(&inv);
+  s21_remove_matrix(&product);
+  for (int j = 0; j < a.columns; j++) a.matrix[100][j] = 2 * a.matrix[7][j];
+  ck_assert_int_eq(s21_inverse_matrix(&a, &inv), CALCULATION_ERROR);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&eye);
+}
+END_TEST
+
 START_TEST(inverse_mtrx_1x1) {
   matrix_t a, test, result;
   s21_create_matrix(1, 1, &a);
@@ -400,21 +1396,46 @@ Suite *test_s21_matrix_suite(void) {
   tcase_add_test(tc_util, complem_invalid_input);
 
   tcase_add_test(tc_util, create_mtrx);
+  tcase_add_test(tc_util, create_mtrx_layout);
   tcase_add_test(tc_util, remove_mtrx);
   tcase_add_test(tc_util, eq_mtrx);
   tcase_add_test(tc_util, not_eq_matr);
   tcase_add_test(tc_util, sum_mtrx);
   tcase_add_test(tc_util, sub_mtrx);
   tcase_add_test(tc_util, mult_num);
+  tcase_add_test(tc_util, isa_levels);
   tcase_add_test(tc_util, mult_mtrx);
+  tcase_add_test(tc_util, mult_mtrx_blocked);
   tcase_add_test(tc_util, mtrx_det);
   tcase_add_test(tc_util, mtrx_det_1x1);
   tcase_add_test(tc_util, transpose_mtrx);
   tcase_add_test(tc_util, inverse_mtrx);
   tcase_add_test(tc_util, complem_mtrx);
   tcase_add_test(tc_util, complem_mtrx_1x1);
+  tcase_add_test(tc_util, complem_mtrx_singular);
   tcase_add_test(tc_util, mult_err_mtrx);
   tcase_add_test(tc_util, inverse_mtrx_1x1);
+  tcase_add_test(tc_util, inverse_mtrx_large);
+  tcase_add_test(tc_util, lu_reuse);
+  tcase_add_test(tc_util, lu_singular);
+  tcase_add_test(tc_util, lu_arena_scope);
+  tcase_add_test(tc_util, into_reuses_storage);
+  tcase_add_test(tc_util, into_aliasing);
+  tcase_add_test(tc_util, arena_scope);
+  tcase_add_test(tc_util, mult_mtrx_threaded);
+  tcase_add_test(tc_util, transpose_mtrx_large);
+  tcase_add_test(tc_util, transpose_inplace);
+  tcase_add_test(tc_util, mult_mtrx_strassen);
+  tcase_add_test(tc_util, mult_mtrx_batched);
+  tcase_add_test(tc_util, mult_mtrx_strided);
+  tcase_add_test(tc_util, det_inverse_batched);
+  tcase_add_test(tc_util, expr_chain);
+  tcase_add_test(tc_util, stats_counters);
+  tcase_add_test(tc_util, matrix_file);
+  tcase_add_test(tc_util, mult_matrix_file);
+  tcase_add_test(tc_util, sparse_matrix);
+  tcase_add_test(tc_util, cholesky_spd);
+  tcase_add_test(tc_util, solve_system);
 
   suite_add_tcase(ret, tc_util);
   return ret;
@@ -0,0 +1,202 @@
+#include <check.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_matrix.hpp"
+
+#define RED "\033[31m"
+#define GREEN "\033[32m"
+#define NOCOLOR "\033[0m"
+
+namespace {
+
+constexpr s21::Matrix3d kRotation{0, -1, 0, 1, 0, 0, 0, 0, 1};
+constexpr s21::Matrix3d kShear{2, 5, 7, 6, 3, 4, 5, -2, -3};
+
+static_assert(kRotation.Determinant() == 1.0);
+static_assert(kShear.Determinant() == -1.0);
+static_assert(kShear.Inverse() * kShear == s21::Matrix3d::Identity());
+static_assert((kRotation * kRotation.Transpose()).EqMatrix(
+    s21::Matrix3d::Identity()));
+static_assert(sizeof(s21::Matrix4d) == 16 * sizeof(double));
+
+template <int N>
+s21::Matrix<N, N> RandomMatrix() {
+  s21::Matrix<N, N> a;
+  for (int i = 0; i < N; i++)
+    for (int j = 0; j < N; j++)
+      a(i, j) = rand() / (double)RAND_MAX - 0.5 + (i == j) * N;
+  return a;
+}
+
+/* fixed-size results against the C functions on the same input */
+template <int N>
+void CheckAgainstC() {
+  s21::Matrix<N, N> a = RandomMatrix<N>(), b = RandomMatrix<N>();
+  s21::DynMatrix da(a), db(b);
+  double det = 0.0;
+  ck_assert_int_eq(s21_determinant(da.Get(), &det), OK);
+  ck_assert_double_eq_tol(a.Determinant(), det, 1e-9);
+  ck_assert(s21::DynMatrix(a.Inverse()) == da.Inverse());
+  ck_assert(s21::DynMatrix(a.CalcComplements()) == da.CalcComplements());
+  ck_assert(s21::DynMatrix(a * b) == da * db);
+  ck_assert(s21::DynMatrix(a * 2.0 - b) == da * 2.0 - db);
+  ck_assert(a.Inverse() * a == (s21::Matrix<N, N>::Identity()));
+}
+
+}  // namespace
+
+START_TEST(fixed_mtrx) {
+  CheckAgainstC<1>();
+  CheckAgainstC<2>();
+  CheckAgainstC<3>();
+  CheckAgainstC<4>();
+  CheckAgainstC<5>();
+  CheckAgainstC<7>();
+
+  s21::Matrix<2, 3> a{1, 2, 3, 4, 5, 6};
+  s21::Matrix<3, 2> t = a.Transpose();
+  ck_assert_double_eq(t(2, 1), 6.0);
+  s21::Matrix<2, 2> p = a * t;
+  ck_assert(p == (s21::Matrix2d{14, 32, 32, 77}));
+
+  bool thrown = false;
+  try {
+    s21::Matrix3d{1, 2, 3, 4, 5, 6, 7, 8, 9}.Inverse();
+  } catch (const std::domain_error &) {
+    thrown = true;
+  }
+  ck_assert(thrown);
+  thrown = false;
+  try {
+    s21::Matrix<5, 5>().Inverse();
+  } catch (const std::domain_error &) {
+    thrown = true;
+  }
+  ck_assert(thrown);
+}
+END_TEST
+
+START_TEST(dynamic_mtrx) {
+  s21::DynMatrix a(3, 3);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) a(i, j) = kShear(i, j);
+  ck_assert_double_eq_tol(a.Determinant(), -1.0, 1e-9);
+  ck_assert(a.Inverse() == s21::DynMatrix(kShear.Inverse()));
+
+  s21::DynMatrix b = a.Clone();
+  b *= 2.0;
+  ck_assert_double_eq(a(0, 1), 5.0);
+  ck_assert_double_eq(b(0, 1), 10.0);
+  s21::DynMatrix c = std::move(b);
+  ck_assert_ptr_null(b.Get()->matrix);
+  c -= a;
+  ck_assert(c == a);
+  c *= a;
+  ck_assert(c == a * a);
+
+  bool thrown = false;
+  try {
+    s21::DynMatrix(2, 3).Determinant();
+  } catch (const std::domain_error &) {
+    thrown = true;
+  }
+  ck_assert(thrown);
+  thrown = false;
+  try {
+    a + s21::DynMatrix(2, 3);
+  } catch (const std::domain_error &) {
+    thrown = true;
+  }
+  ck_assert(thrown);
+  thrown = false;
+  try {
+    s21::DynMatrix(0, 3);
+  } catch (const std::invalid_argument &) {
+    thrown = true;
+  }
+  ck_assert(thrown);
+}
+END_TEST
+
+START_TEST(expr_mtrx) {
+  s21::DynMatrix a(37, 53), b(37, 53), c(37, 53), d(37, 53);
+  for (int i = 0; i < 37; i++) {
+    for (int j = 0; j < 53; j++) {
+      a(i, j) = i - j;
+      b(i, j) = i * 0.5 + j;
+      c(i, j) = j * 0.25;
+    }
+  }
+  double *storage = &d(0, 0);
+  d = a + b * 2.0 - c;
+  ck_assert_ptr_eq(&d(0, 0), storage);
+  matrix_t expected{};
+  s21_mult_number(a.Get(), 2.0, &expected);
+  for (int i = 0; i < 37; i++)
+    for (int j = 0; j < 53; j++)
+      ck_assert_double_eq(d(i, j), a(i, j) + b(i, j) * 2.0 - c(i, j));
+
+  s21::MatrixRef ref(expected);
+  d = ref - a - a + -(b / 4.0) * 4.0;
+  ck_assert(d == -1.0 * b);
+  d += a;
+  d -= 2.0 * a;
+  d *= -1.0;
+  ck_assert(d == a + b);
+
+  s21::DynMatrix t = a.Transpose(), p = (a + b) * t;
+  ck_assert_int_eq(p.Rows(), 37);
+  ck_assert_int_eq(p.Cols(), 37);
+  ck_assert(p == d * s21::MatrixRef(*t.Get()));
+  p *= a - a + ref;
+  ck_assert(p == d * t * ref);
+  ck_assert_int_eq(p.Cols(), 53);
+
+  s21::DynMatrix owned = s21::DynMatrix::Adopt(expected);
+  ck_assert_ptr_eq(owned.Get()->matrix, expected.matrix);
+  matrix_t back = owned.Release();
+  ck_assert_ptr_null(owned.Get()->matrix);
+  s21_remove_matrix(&back);
+
+  bool thrown = false;
+  try {
+    d = a + t;
+  } catch (const std::domain_error &) {
+    thrown = true;
+  }
+  ck_assert(thrown);
+}
+END_TEST
+
+Suite *test_s21_matrix_hpp_suite(void) {
+  Suite *ret = suite_create("s21_matrix_hpp");
+
+  TCase *tc_util = tcase_create("all");
+
+  tcase_add_test(tc_util, fixed_mtrx);
+  tcase_add_test(tc_util, dynamic_mtrx);
+  tcase_add_test(tc_util, expr_mtrx);
+
+  suite_add_tcase(ret, tc_util);
+  return ret;
+}
+
+int main(void) {
+  int failed = 0, total = 0;
+  SRunner *sr = srunner_create(test_s21_matrix_hpp_suite());
+  srunner_set_fork_status(sr, CK_NOFORK);
+  srunner_run_all(sr, CK_NORMAL);
+
+  total = srunner_ntests_run(sr);
+  failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  printf("\nTEST RESULT " GREEN "\nTOTAL:\t%d" RED
+         "\nFAILED:\t"
+         "%d" NOCOLOR "\n",
+         total, failed);
+  return failed;
+}